@@ -0,0 +1,306 @@
+#include "admission.h"
+#include "globals.h"
+#include "process.h"
+#include "memory.h"
+#include "metrics.h"
+#include "registry.h"
+#include "rng.h"
+#include "workload.h"
+#include "replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Forward declaration from scheduler.cpp
+std::shared_ptr<ProcessControlBlock> build_random_process(int pid, const std::string& name, size_t memorySize);
+
+static std::mutex admission_mutex; // serializes admission; guards pending and the programs of processes in it
+static std::deque<std::shared_ptr<ProcessControlBlock>> pending;
+static std::atomic<size_t> pending_count{0};
+
+static bool queue_for_preparation(const std::vector<std::shared_ptr<ProcessControlBlock>>& unprepared);
+
+// Processes rejected as too big for memory; guarded by admission_mutex
+static uint64_t rejected_count = 0;
+static std::string last_rejected;
+
+bool admission_possible(size_t bytes, std::string& error) {
+    if (!globalMemory || globalMemory->fitsCommitLimit(bytes)) return true;
+    error = std::to_string(bytes) + " bytes exceeds the memory commit limit of " +
+            std::to_string(globalMemory->getStats().commitLimit) + " bytes";
+    return false;
+}
+
+void admit_processes(std::vector<std::shared_ptr<ProcessControlBlock>> batch) {
+    std::sort(batch.begin(), batch.end(),
+              [](const auto& a, const auto& b) { return a->process->pid < b->process->pid; });
+    // A process that can never fit is rejected before it is prepared; waiting
+    // for memory would stall the queue behind it forever
+    batch.erase(std::remove_if(batch.begin(), batch.end(), [](const auto& pcb) {
+        std::string error;
+        if (admission_possible(pcb->process->memorySize, error)) return false;
+        std::lock_guard<std::mutex> lock(admission_mutex);
+        rejected_count++;
+        last_rejected = pcb->process->name + ": " + error;
+        return true;
+    }), batch.end());
+    for (const auto& pcb : batch) capture_process(*pcb);
+
+    std::vector<std::shared_ptr<ProcessControlBlock>> unprepared;
+    for (const auto& pcb : batch) {
+        if (!pcb->flattenedInstructions) unprepared.push_back(pcb);
+    }
+    if (!unprepared.empty() && !queue_for_preparation(unprepared)) {
+        for (const auto& pcb : unprepared) prepare_process(*pcb);
+    }
+
+    std::vector<std::shared_ptr<ProcessControlBlock>> admitted;
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex);
+        for (auto& pcb : batch) pending.push_back(std::move(pcb));
+        // Strict FIFO: once one process is not prepared or does not fit, everything behind it waits too
+        while (!pending.empty()) {
+            auto& pcb = pending.front();
+            if (!pcb->flattenedInstructions) break; // a preparation worker admits it when done
+            if (globalMemory && !globalMemory->allocateProcess(pcb->process->pid, pcb->process->memorySize)) break;
+            admitted.push_back(std::move(pcb));
+            pending.pop_front();
+        }
+        pending_count = pending.size();
+    }
+    if (admitted.empty()) return;
+
+    for (auto& pcb : admitted) process_registry.add(pcb);
+    {
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        for (auto& pcb : admitted) ready_queue.push(pcb);
+    }
+    if (admitted.size() == 1) ready_cv.notify_one();
+    else ready_cv.notify_all();
+}
+
+size_t pending_admissions() {
+    return pending_count.load(std::memory_order_relaxed);
+}
+
+void clear_pending_admissions() {
+    std::lock_guard<std::mutex> lock(admission_mutex);
+    pending.clear();
+    pending_count = 0;
+}
+
+// ---- program preparation ----
+
+struct PreparationJob {
+    std::shared_ptr<ProcessControlBlock> pcb;
+    std::chrono::steady_clock::time_point queued;
+};
+
+static std::mutex prepare_mutex; // guards everything below
+static std::condition_variable prepare_cv;
+static bool prepare_active = false;
+static std::deque<PreparationJob> prepare_queue;
+static std::vector<std::thread> preparer_threads;
+static std::atomic<size_t> preparing{0}; // queued or being prepared
+
+static void record_preparation(std::chrono::steady_clock::time_point queued) {
+    auto waited = std::chrono::steady_clock::now() - queued;
+    preparation_latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()));
+}
+
+void prepare_process(ProcessControlBlock& pcb) {
+    if (pcb.flattenedInstructions) return;
+    auto start = std::chrono::steady_clock::now();
+    pcb.flattenedInstructions = flatten_program(pcb);
+    pcb.staticLength(); // cached now rather than on the first scheduling decision
+    record_preparation(start);
+}
+
+// Hands `unprepared` to the pool; false if it is not running
+static bool queue_for_preparation(const std::vector<std::shared_ptr<ProcessControlBlock>>& unprepared) {
+    std::lock_guard<std::mutex> lock(prepare_mutex);
+    if (!prepare_active) return false;
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& pcb : unprepared) prepare_queue.push_back({pcb, now});
+    preparing += unprepared.size();
+    if (unprepared.size() == 1) prepare_cv.notify_one();
+    else prepare_cv.notify_all();
+    return true;
+}
+
+static void preparation_worker() {
+    std::unique_lock<std::mutex> lock(prepare_mutex);
+    while (true) {
+        prepare_cv.wait(lock, [] { return !prepare_active || !prepare_queue.empty(); });
+        if (!prepare_active) return;
+        PreparationJob job = std::move(prepare_queue.front());
+        prepare_queue.pop_front();
+        lock.unlock();
+
+        auto flat = flatten_program(*job.pcb);
+        {
+            // The process already sits in pending, where admission looks at it under this lock
+            std::lock_guard<std::mutex> admission(admission_mutex);
+            job.pcb->flattenedInstructions = std::move(flat);
+            job.pcb->staticLength();
+        }
+        record_preparation(job.queued);
+        preparing--;
+        admit_processes({}); // it may have been holding up the head of the queue
+
+        lock.lock();
+    }
+}
+
+void preparation_pool_start(int threads) {
+    std::lock_guard<std::mutex> lock(prepare_mutex);
+    if (prepare_active) return;
+    prepare_active = true;
+    for (int i = 0; i < std::max(1, threads); ++i) preparer_threads.emplace_back(preparation_worker);
+}
+
+void preparation_pool_stop() {
+    {
+        std::lock_guard<std::mutex> lock(prepare_mutex);
+        if (!prepare_active) return;
+        prepare_active = false;
+    }
+    prepare_cv.notify_all();
+    for (auto& t : preparer_threads) if (t.joinable()) t.join();
+    preparer_threads.clear();
+    std::lock_guard<std::mutex> lock(prepare_mutex);
+    prepare_queue.clear(); // their processes are still pending and are dropped with it
+    preparing = 0;
+}
+
+std::string format_preparation() {
+    uint64_t count = preparation_latency.count();
+    size_t queued = preparing.load();
+    if (count == 0 && queued == 0) return "";
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "Program preparation: %llu prepared, mean %.1f us, p99 %.1f us, max %.1f us, %zu in progress\n",
+                  static_cast<unsigned long long>(count), preparation_latency.mean() / 1000.0,
+                  preparation_latency.percentile(99) / 1000.0, preparation_latency.max() / 1000.0, queued);
+    return buf;
+}
+
+std::string format_admission_rejects() {
+    std::lock_guard<std::mutex> lock(admission_mutex);
+    if (rejected_count == 0) return "";
+    return "Admission: " + std::to_string(rejected_count) + " rejected as too big for memory (last " +
+           last_rejected + ")\n";
+}
+
+size_t generated_process_memory() {
+    if (auto profile = active_workload()) {
+        size_t size = workload_process_memory(*profile);
+        if (size > 0) return size;
+    }
+    // Use configured per-process memory from config (bytes)
+    size_t memLow = std::max<size_t>(64, min_mem_per_proc);
+    size_t memHigh = std::max(memLow, max_mem_per_proc);
+    return memHigh; // choose upper bound to stress paging
+}
+
+// ---- generator pool ----
+
+static std::mutex pool_mutex; // guards everything below
+static std::condition_variable pool_cv;
+static bool pool_active = false;
+struct Arrival {
+    int pid;
+    std::string name;
+};
+static std::deque<Arrival> arrivals;  // due, in arrival order, that no worker has started building
+static int building = 0;        // processes being built right now
+static std::vector<std::shared_ptr<ProcessControlBlock>> built;
+static std::thread coordinator_thread;
+static std::vector<std::thread> worker_threads;
+
+// Work in flight behind admission; workers stop building at the limit
+static bool backlog_full() {
+    return built.size() + static_cast<size_t>(building) + pending_admissions() >= MAX_PENDING_ADMISSIONS;
+}
+
+static void generator_worker() {
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    while (true) {
+        pool_cv.wait(lock, [] { return !pool_active || (!arrivals.empty() && !backlog_full()); });
+        if (!pool_active) return;
+        Arrival arrival = std::move(arrivals.front());
+        arrivals.pop_front();
+        building++;
+        lock.unlock();
+        // The stream follows the PID, so with a fixed seed a process's program does not
+        // depend on which worker happened to build it
+        rng_bind_stream(RNG_STREAM_GENERATOR_POOL + static_cast<uint32_t>(arrival.pid));
+        auto pcb = build_random_process(arrival.pid, arrival.name, generated_process_memory());
+        lock.lock();
+        building--;
+        built.push_back(std::move(pcb));
+    }
+}
+
+// Paces arrivals (one per batch-process-freq ticks) and admits each tick's output as one batch
+static void generator_coordinator() {
+    int ticksUntilArrival = 0;
+    while (scheduler_running && is_running) {
+        std::vector<std::shared_ptr<ProcessControlBlock>> batch;
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (!pool_active) break;
+            if (ticksUntilArrival <= 0) {
+                // Capped, so a long memory stall does not release a burst of arrivals afterwards.
+                // PIDs and names are handed out here, in arrival order, not by the workers.
+                if (arrivals.size() < MAX_PENDING_ADMISSIONS) arrivals.push_back({generate_pid(), generate_process_name()});
+                ticksUntilArrival = std::max(1, batch_process_freq);
+                pool_cv.notify_one();
+            }
+            batch.swap(built);
+        }
+        if (!batch.empty() || pending_admissions() > 0) {
+            admit_processes(std::move(batch));
+            pool_cv.notify_all(); // the backlog may have shrunk
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        cpuCycles++;
+        ticksUntilArrival--;
+    }
+}
+
+void generator_pool_start(int threads) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    if (pool_active) return;
+    pool_active = true;
+    arrivals.clear();
+    building = 0;
+    built.clear();
+    for (int i = 0; i < std::max(1, threads); ++i) worker_threads.emplace_back(generator_worker);
+    coordinator_thread = std::thread(generator_coordinator);
+}
+
+void generator_pool_stop() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (!pool_active) return;
+        pool_active = false;
+    }
+    pool_cv.notify_all();
+    if (coordinator_thread.joinable()) coordinator_thread.join();
+    for (auto& t : worker_threads) if (t.joinable()) t.join();
+    worker_threads.clear();
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    built.clear(); // never registered, so nothing else refers to them
+    arrivals.clear();
+}
+
+bool generator_pool_running() {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    return pool_active;
+}
@@ -0,0 +1,55 @@
+#ifndef CSOPESY_ADMISSION_H
+#define CSOPESY_ADMISSION_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ProcessControlBlock;
+
+// Admission of new processes into memory, the registry and the ready queue.
+// A batch is admitted in PID order behind any processes already pending:
+// each gets its memory, then the whole batch becomes ready under one lock.
+// Processes that do not fit in memory wait in a FIFO pending queue and are
+// retried as memory is freed, instead of being dropped. One larger than the
+// commit limit could never fit, so it is rejected up front.
+//
+// Programs are prepared (FOR bodies flattened, nesting checked) before a
+// process is admitted, so no core does it on first dispatch. While the
+// preparation pool runs, admit_processes hands unprepared processes to it and
+// they wait at their place in the pending queue; otherwise (virtual time)
+// they are prepared inline.
+constexpr size_t MAX_PENDING_ADMISSIONS = 256;  // generators pause at this backlog
+
+// Admits `batch`; an empty batch just retries the pending queue. A process too
+// big for memory even when nothing else is allocated is rejected and counted.
+void admit_processes(std::vector<std::shared_ptr<ProcessControlBlock>> batch);
+// False (with `error` set) if a process of `bytes` could never be admitted
+bool admission_possible(size_t bytes, std::string& error);
+// Processes built but still waiting for preparation or memory
+size_t pending_admissions();
+// Drops processes that were never admitted (scheduler-stop)
+void clear_pending_admissions();
+
+// Flattens pcb's program now unless it already has one (processes created outside admit_processes)
+void prepare_process(ProcessControlBlock& pcb);
+// Preparation workers for threaded mode, started and stopped with the scheduler
+void preparation_pool_start(int threads);
+void preparation_pool_stop();
+// Preparation latency and backlog for vmstat
+std::string format_preparation();
+// Processes rejected as too big for memory, for vmstat (empty if none)
+std::string format_admission_rejects();
+
+// Memory size for a generated process (the workload profile's mem-size, if set)
+size_t generated_process_memory();
+
+// scheduler-test generator pool: `threads` workers build processes in
+// parallel at the rate set by batch-process-freq, and a coordinator admits
+// everything built during each tick as one batch
+void generator_pool_start(int threads);
+void generator_pool_stop();
+bool generator_pool_running();
+
+#endif // CSOPESY_ADMISSION_H
@@ -0,0 +1,71 @@
+#include "archive.h"
+#include "process.h"
+#include "utils.h"
+
+ProcessArchive process_archive;
+
+void ProcessArchive::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    if (out.is_open()) out.close();
+    archivePath = path;
+    // binary so byte offsets match what we count on every platform
+    out.open(archivePath, std::ios::binary | std::ios::trunc);
+    bytesWritten = 0;
+    const std::string header = "# CSOPESY Process Archive\n# Format: == NAME PID LINES, followed by LINES log lines\n";
+    out << header;
+    bytesWritten += header.size();
+}
+
+std::shared_ptr<const RetiredProcess> ProcessArchive::retire(const ProcessControlBlock& pcb) {
+    auto record = std::make_shared<RetiredProcess>();
+    record->name = pcb.process->name;
+    record->pid = pcb.process->pid;
+    record->finishTime = get_timestamp();
+    record->instructionsExecuted = pcb.programCounter;
+    record->totalInstructions = pcb.flattenedInstructions ? static_cast<int>(pcb.flattenedInstructions->size())
+                                                          : static_cast<int>(pcb.sourceProgram().size());
+    record->completed = (pcb.processState == State::TERMINATED);
+    record->hasMemoryViolation = pcb.hasMemoryViolation;
+    record->memoryViolationTime = pcb.memoryViolationTime;
+    record->memoryViolationAddress = pcb.memoryViolationAddress;
+    record->arrived = pcb.arrived;
+    record->hasRun = pcb.hasRun;
+    record->arrivalTick = pcb.arrivalTick;
+    record->firstRunTick = pcb.firstRunTick;
+    record->finishTick = record->completed ? pcb.finishTick : 0;
+    record->waitingTicks = pcb.waitingTicks;
+    record->logCount = pcb.logs.size();
+
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    if (!out.is_open()) return record; // archive never opened; keep summary only
+    std::string header = "== " + record->name + " " + std::to_string(record->pid) + " " +
+                         std::to_string(record->logCount) + "\n";
+    out << header;
+    bytesWritten += header.size();
+    record->logOffset = bytesWritten;
+    for (const auto& line : pcb.logs) {
+        out << line << '\n';
+        bytesWritten += line.size() + 1;
+    }
+    return record;
+}
+
+std::vector<std::string> ProcessArchive::readLogs(const RetiredProcess& record) {
+    std::vector<std::string> logs;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(archiveMutex);
+        if (!out.is_open()) return logs;
+        out.flush(); // make buffered appends visible to the reader
+        path = archivePath;
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return logs;
+    in.seekg(static_cast<std::streamoff>(record.logOffset));
+    logs.reserve(record.logCount);
+    std::string line;
+    while (logs.size() < record.logCount && std::getline(in, line)) {
+        logs.push_back(line);
+    }
+    return logs;
+}
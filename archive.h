@@ -0,0 +1,64 @@
+#ifndef CSOPESY_ARCHIVE_H
+#define CSOPESY_ARCHIVE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ProcessControlBlock;
+
+// Compact summary kept for every finished process once its PCB is released.
+// The full execution log lives in the archive file at logOffset.
+struct RetiredProcess {
+    std::string name;
+    int pid = 0;
+    std::string finishTime;
+    int instructionsExecuted = 0;
+    int totalInstructions = 0;
+    bool completed = false;               // false if stopped by scheduler-stop
+
+    bool hasMemoryViolation = false;
+    std::string memoryViolationTime;
+    size_t memoryViolationAddress = 0;
+
+    // Scheduling timeline, in CPU ticks (copied from the PCB)
+    bool arrived = false;
+    bool hasRun = false;
+    uint64_t arrivalTick = 0;
+    uint64_t firstRunTick = 0;
+    uint64_t finishTick = 0;              // 0 unless completed
+    uint64_t waitingTicks = 0;
+    uint64_t responseTicks() const { return firstRunTick - std::min(firstRunTick, arrivalTick); }
+    uint64_t turnaroundTicks() const { return finishTick - std::min(finishTick, arrivalTick); }
+
+    uint64_t logOffset = 0;               // byte offset of the first log line
+    size_t logCount = 0;
+};
+
+// Append-only archive of finished process logs
+class ProcessArchive {
+public:
+    // Truncates the archive file and starts a fresh session
+    void open(const std::string& path = "csopesy-archive.txt");
+
+    // Spills pcb's logs to the archive and returns its summary record
+    std::shared_ptr<const RetiredProcess> retire(const ProcessControlBlock& pcb);
+
+    // Reads a retired process's logs back from disk
+    std::vector<std::string> readLogs(const RetiredProcess& record);
+
+private:
+    std::mutex archiveMutex;
+    std::string archivePath;
+    std::ofstream out;
+    uint64_t bytesWritten = 0;
+};
+
+// Global archive instance
+extern ProcessArchive process_archive;
+
+#endif // CSOPESY_ARCHIVE_H
@@ -0,0 +1,292 @@
+// microbench.cpp
+// Isolated microbenchmarks for the emulator's hot paths. Reports ns/op and
+// heap allocations/op. Build from the project folder (everything but main.cpp):
+//   g++ -std=c++17 -O2 -pthread -I. bench/microbench.cpp $(ls *.cpp | grep -v '^main.cpp$') -o microbench
+#include "globals.h"
+#include "process.h"
+#include "memory.h"
+#include "parser.h"
+#include "utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+// Forward declaration from scheduler.cpp
+std::shared_ptr<ProcessControlBlock> generate_random_process(size_t memorySize);
+
+// ---- Allocation counting ----
+static std::atomic<uint64_t> allocation_count{0};
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC pairs free() with the library operator new, not the replacement below
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Grants the benchmarks access to Memory's private eviction scan
+struct MemoryBenchmarkAccess {
+    static int findOldestFrameLRU(Memory& m) { return m.findOldestFrameLRU(); }
+};
+
+// ---- Harness ----
+static volatile uint64_t sink; // keeps results observable so they are not optimized away
+
+// Runs op(iterations) with a growing iteration count until one run takes >= 200 ms
+static void run_bench(const std::string& name, const std::function<void(uint64_t)>& op) {
+    using clock = std::chrono::steady_clock;
+    uint64_t iterations = 1;
+    while (true) {
+        uint64_t allocsBefore = allocation_count.load(std::memory_order_relaxed);
+        auto start = clock::now();
+        op(iterations);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+        uint64_t allocs = allocation_count.load(std::memory_order_relaxed) - allocsBefore;
+        if (elapsed >= 200000000 || iterations >= (uint64_t{1} << 30)) {
+            std::printf("%-40s %14.1f ns/op %10.2f allocs/op %12llu iters\n", name.c_str(),
+                        static_cast<double>(elapsed) / iterations, static_cast<double>(allocs) / iterations,
+                        static_cast<unsigned long long>(iterations));
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+// A process whose program is `count` copies of one instruction, already flattened
+static std::shared_ptr<ProcessControlBlock> make_process(const Instruction& instr, size_t count, size_t memSize) {
+    auto pcb = std::make_shared<ProcessControlBlock>();
+    pcb->process = std::make_unique<Process>();
+    pcb->process->pid = generate_pid();
+    pcb->process->name = "bench" + std::to_string(pcb->process->pid);
+    pcb->process->memorySize = memSize;
+    pcb->initializeMemory(memSize);
+    auto program = std::make_shared<CompiledProgram>();
+    program->instructions.assign(count, instr);
+    flatten_instructions(program->instructions, program->flattened);
+    pcb->setProgram(std::move(program));
+    if (globalMemory) globalMemory->allocateProcess(pcb->process->pid, memSize);
+    return pcb;
+}
+
+static void bench_execute(const std::string& label, const Instruction& instr) {
+    auto pcb = make_process(instr, 1024, 4096);
+    run_bench("execute_instruction/" + label, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            if (pcb->programCounter >= static_cast<int>(pcb->flattenedInstructions->size())) pcb->programCounter = 0;
+            pcb->processState = State::READY;
+            pcb->sleepTicks = 0;
+            if (pcb->logs.size() >= 4096) pcb->logs.clear();
+            execute_instruction(*pcb, 0);
+        }
+        sink = static_cast<uint64_t>(pcb->programCounter);
+    });
+    globalMemory->deallocateProcess(pcb->process->pid);
+}
+
+int main() {
+    // Small, deterministic memory configuration: 1 KB pages, 16 frames
+    mem_per_frame = 1;
+    max_mem_per_proc = 16;
+    initializeMemory(16 * 1024);
+    globalMemory = std::make_unique<Memory>(16 * 1024, "microbench-backing-store.txt");
+
+    std::printf("%-40s %17s %17s\n", "benchmark", "time", "allocations");
+
+    // -- execute_instruction, one instruction type at a time --
+    {
+        Instruction print;
+        print.type = PRINT;
+        print.arg2 = "Value from: x";
+        bench_execute("PRINT", print);
+
+        Instruction printVar;
+        printVar.type = PRINT;
+        printVar.arg1 = "(\"Result: \" + x)";
+        bench_execute("PRINT(user)", printVar);
+
+        Instruction declare;
+        declare.type = DECLARE;
+        declare.arg1 = "x";
+        declare.val1 = 5;
+        bench_execute("DECLARE", declare);
+
+        Instruction add;
+        add.type = ADD;
+        add.arg1 = "x";
+        add.arg2 = "x";
+        add.arg3 = "y";
+        bench_execute("ADD", add);
+
+        Instruction sub;
+        sub.type = SUBTRACT;
+        sub.arg1 = "x";
+        sub.arg2 = "x";
+        sub.arg3 = "y";
+        bench_execute("SUBTRACT", sub);
+
+        Instruction sleep;
+        sleep.type = SLEEP;
+        sleep.val1 = 3;
+        bench_execute("SLEEP", sleep);
+
+        Instruction read;
+        read.type = READ_MEM;
+        read.arg1 = "x";
+        read.arg2 = "0x100";
+        bench_execute("READ", read);
+
+        Instruction write;
+        write.type = WRITE_MEM;
+        write.arg1 = "0x100";
+        write.arg2 = "x";
+        bench_execute("WRITE", write);
+    }
+
+    // -- Memory::accessMemory --
+    {
+        int pid = generate_pid();
+        globalMemory->allocateProcess(pid, 4096);
+        globalMemory->accessMemory(pid, 0, false);
+        run_bench("Memory::accessMemory/hit", [&](uint64_t n) {
+            bool ok = true;
+            for (uint64_t i = 0; i < n; ++i) ok &= globalMemory->accessMemory(pid, 64, false);
+            sink = ok;
+        });
+        globalMemory->deallocateProcess(pid);
+
+        // 64 pages cycled through 16 frames: every access evicts the LRU frame
+        int big = generate_pid();
+        globalMemory->allocateProcess(big, 64 * 1024);
+        size_t page = 0;
+        run_bench("Memory::accessMemory/fault", [&](uint64_t n) {
+            bool ok = true;
+            for (uint64_t i = 0; i < n; ++i) {
+                ok &= globalMemory->accessMemory(big, page * 1024, true);
+                page = (page + 1) % 64;
+            }
+            sink = ok;
+        });
+
+        run_bench("Memory::findOldestFrameLRU/16", [&](uint64_t n) {
+            int idx = 0;
+            for (uint64_t i = 0; i < n; ++i) idx += MemoryBenchmarkAccess::findOldestFrameLRU(*globalMemory);
+            sink = static_cast<uint64_t>(idx);
+        });
+        globalMemory->deallocateProcess(big);
+
+        // Same scan over a larger frame table
+        max_mem_per_proc = 1024;
+        Memory large(1024 * 1024, "microbench-backing-store.txt");
+        int lp = generate_pid();
+        large.allocateProcess(lp, 1024 * 1024);
+        for (size_t p = 0; p < 1024; ++p) large.accessMemory(lp, p * 1024, false);
+        run_bench("Memory::findOldestFrameLRU/1024", [&](uint64_t n) {
+            int idx = 0;
+            for (uint64_t i = 0; i < n; ++i) idx += MemoryBenchmarkAccess::findOldestFrameLRU(large);
+            sink = static_cast<uint64_t>(idx);
+        });
+        max_mem_per_proc = 16;
+    }
+
+    // -- Parsing and flattening --
+    {
+        // The parenthesized PRINT form must parse before it is worth timing anything
+        {
+            std::vector<Instruction> parsed;
+            ParseError error;
+            if (!parse_program("DECLARE x 1; PRINT(\"Result: \" + x)", parsed, error) || parsed.size() != 2 ||
+                parsed[1].type != PRINT || parsed[1].arg1 != "(\"Result: \" + x)") {
+                std::printf("parse check failed: PRINT(\"Result: \" + x) %s\n", error.describe().c_str());
+                return 1;
+            }
+        }
+
+        std::string program;
+        for (int i = 0; i < 10; ++i) {
+            program += "DECLARE varA 10; DECLARE varB 5; ADD varA varA varB; WRITE 0x500 varA; READ varC 0x500; ";
+        }
+        run_bench("parse_program/50", [&](uint64_t n) {
+            size_t total = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                std::vector<Instruction> parsed;
+                ParseError error;
+                parse_program(program, parsed, error);
+                total += parsed.size();
+            }
+            sink = total;
+        });
+
+        // 3-level nest: 4 x (2 + 4 x (2 + 4 x 3)) = 232 flat instructions
+        Instruction leaf;
+        leaf.type = ADD;
+        leaf.arg1 = "x";
+        leaf.arg2 = "x";
+        leaf.arg3 = "y";
+        Instruction inner;
+        inner.type = FOR_LOOP;
+        inner.val1 = 4;
+        inner.instrSet.assign(3, leaf);
+        Instruction middle;
+        middle.type = FOR_LOOP;
+        middle.val1 = 4;
+        middle.instrSet.assign(2, leaf);
+        middle.instrSet.push_back(inner);
+        Instruction outer;
+        outer.type = FOR_LOOP;
+        outer.val1 = 4;
+        outer.instrSet.assign(2, leaf);
+        outer.instrSet.push_back(middle);
+        std::vector<Instruction> nested(1, outer);
+        run_bench("flatten_instructions/nested", [&](uint64_t n) {
+            size_t total = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                std::vector<Instruction> flat;
+                flatten_instructions(nested, flat);
+                total += flat.size();
+            }
+            sink = total;
+        });
+    }
+
+    // -- Process generation --
+    {
+        min_ins = 1000;
+        max_ins = 1000;
+        run_bench("generate_random_process/1000", [&](uint64_t n) {
+            size_t total = 0;
+            for (uint64_t i = 0; i < n; ++i) total += generate_random_process(4096)->process->instructions.size();
+            sink = total;
+        });
+    }
+
+    // -- Ready queue --
+    {
+        std::vector<std::shared_ptr<ProcessControlBlock>> pcbs;
+        for (int i = 0; i < 64; ++i) {
+            auto pcb = std::make_shared<ProcessControlBlock>();
+            pcb->process = std::make_unique<Process>();
+            pcb->process->pid = generate_pid();
+            pcbs.push_back(pcb);
+        }
+        ReadyQueue queue;
+        for (auto& pcb : pcbs) queue.push(pcb);
+        run_bench("ReadyQueue/push+pop", [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) queue.push(queue.pop());
+            sink = queue.size();
+        });
+    }
+
+    return 0;
+}
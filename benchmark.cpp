@@ -0,0 +1,97 @@
+#include "benchmark.h"
+#include "globals.h"
+#include "config.h"
+#include "memory.h"
+#include "metrics.h"
+#include "rng.h"
+#include "snapshot.h"
+#include "archive.h"
+#include "tuner.h"
+#include "utils.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Forward declarations from scheduler.cpp
+void scheduler_test();
+void scheduler_stop();
+
+int run_benchmark(const std::string& config_path, int seconds, std::ostream& out) {
+    headless_mode = true;
+    if (!initialize_from_config(config_path)) {
+        std::cerr << "Failed to open " << config_path << "\n";
+        return 1;
+    }
+
+    reset_scheduler_metrics();
+    MemoryStats memBefore = globalMemory->getStats();
+    int cyclesBefore = cpuCycles.load();
+    auto start = std::chrono::steady_clock::now();
+
+    scheduler_test();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+    // Sample everything before stopping so shutdown work is not measured
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t instructions = instructions_executed.load();
+    uint64_t dispatches = dispatch_count.load();
+    uint64_t switches = context_switches.load();
+    MemoryStats memAfter = globalMemory->getStats();
+    int cycles = cpuCycles.load() - cyclesBefore;
+    // Per-process times come from the finished records, so they cover exactly
+    // the processes that completed during the run
+    auto snap = publish_snapshot();
+    size_t finished = snap->finishedCount;
+    LatencyHistogram response, waiting, turnaround;
+    for (const auto& record : finished_records(*snap)) {
+        if (!record->arrived || !record->completed) continue;
+        if (record->hasRun) response.record(record->responseTicks());
+        waiting.record(record->waitingTicks);
+        turnaround.record(record->turnaroundTicks());
+    }
+    uint64_t latencySamples = scheduling_latency.count();
+    double p50 = scheduling_latency.percentile(50) / 1000.0;
+    double p99 = scheduling_latency.percentile(99) / 1000.0;
+    double meanLatency = scheduling_latency.mean() / 1000.0;
+    double maxLatency = scheduling_latency.max() / 1000.0;
+
+    scheduler_stop();
+
+    uint64_t pageFaults = memAfter.numPagedIn - memBefore.numPagedIn;
+    auto rate = [elapsed](uint64_t n) { return elapsed > 0 ? n / elapsed : 0.0; };
+
+    out << std::fixed << std::setprecision(2);
+    out << "{\n";
+    out << "  \"config\": \"" << json_escape(config_path) << "\",\n";
+    out << "  \"scheduler\": \"" << json_escape(scheduler_type) << "\",\n";
+    out << "  \"num_cpu\": " << num_cpu << ",\n";
+    out << "  \"seed\": " << current_seed() << ",\n";
+    out << "  \"virtual_time\": " << (virtual_time ? "true" : "false") << ",\n";
+    out << "  \"duration_s\": " << elapsed << ",\n";
+    out << "  \"cpu_cycles\": " << cycles << ",\n";
+    out << "  \"instructions\": " << instructions << ",\n";
+    out << "  \"instructions_per_sec\": " << rate(instructions) << ",\n";
+    out << "  \"dispatches\": " << dispatches << ",\n";
+    out << "  \"dispatches_per_sec\": " << rate(dispatches) << ",\n";
+    out << "  \"page_faults\": " << pageFaults << ",\n";
+    out << "  \"page_faults_per_sec\": " << rate(pageFaults) << ",\n";
+    out << "  \"context_switches\": " << switches << ",\n";
+    out << "  \"context_switches_per_sec\": " << rate(switches) << ",\n";
+    out << "  \"migrations\": " << migrations.load() << ",\n";
+    out << "  \"quantum\": " << current_quantum.load() << ",\n";
+    out << "  \"processes_finished\": " << finished << ",\n";
+    out << "  \"sched_latency_us\": {\"samples\": " << latencySamples << ", \"mean\": " << meanLatency
+        << ", \"p50\": " << p50 << ", \"p99\": " << p99 << ", \"max\": " << maxLatency << "},\n";
+    // Per-process times of finished processes, in CPU ticks
+    auto ticks = [&out](const char* name, const LatencyHistogram& h, bool last) {
+        out << "  \"" << name << "_ticks\": {\"mean\": " << h.mean() << ", \"p50\": " << h.percentile(50)
+            << ", \"p99\": " << h.percentile(99) << ", \"max\": " << h.max() << "}" << (last ? "\n" : ",\n");
+    };
+    ticks("response", response, false);
+    ticks("waiting", waiting, false);
+    ticks("turnaround", turnaround, true);
+    out << "}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef CSOPESY_BENCHMARK_H
+#define CSOPESY_BENCHMARK_H
+
+#include <ostream>
+#include <string>
+
+// Initializes from config_path, runs scheduler-test for `seconds` and writes
+// throughput/latency results to `out` as JSON. Returns a process exit code.
+int run_benchmark(const std::string& config_path, int seconds, std::ostream& out);
+
+#endif // CSOPESY_BENCHMARK_H
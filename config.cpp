@@ -0,0 +1,125 @@
+#include "config.h"
+#include "globals.h"
+#include "memory.h"
+#include "program_cache.h"
+#include "archive.h"
+#include "rng.h"
+#include "utils.h"
+#include "workload.h"
+
+#include <fstream>
+#include <sstream>
+
+// Forward declaration from scheduler.cpp
+void scheduler_start();
+
+bool load_config(const std::string& path) {
+    std::ifstream ifs(path);
+    if (!ifs) return false;
+
+    // Optional keys fall back to their defaults when absent
+    config_seed = 0;
+    virtual_time = false;
+    aging_cycles = 200;
+    mlfq_levels = 3;
+    mlfq_quanta.clear();
+    mlfq_boost_cycles = 1000;
+    cfs_target_latency = 48;
+    cfs_min_granularity = 2;
+    affinity_window = 4;
+    migration_cost = 0;
+    quantum_auto = false;
+    quantum_min = 1;
+    quantum_max = 64;
+    quantum_target_switch = 10.0;
+    quantum_target_response = 200;
+    generator_threads = 2;
+    prepare_threads = 2;
+    workload_profile.clear();
+    program_cache_size = DEFAULT_PROGRAM_CACHE_SIZE;
+    max_committed_mem = 0;
+
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(line);
+        std::string key;
+        iss >> key;
+        
+        if (key == "num-cpu") { iss >> num_cpu; }
+        else if (key == "scheduler") { 
+            std::string val; 
+            iss >> val;
+            // Remove quotes if present
+            if (!val.empty() && val.front() == '"') val = val.substr(1);
+            if (!val.empty() && val.back() == '"') val = val.substr(0, val.size()-1);
+            scheduler_type = val;
+            bool known = false;
+            scheduler_policy = parse_scheduler_policy(val, known); // unknown names run as FCFS
+        }
+        else if (key == "quantum-cycles") {
+            std::string val;
+            iss >> val;
+            if (val == "auto") quantum_auto = true;
+            else parse_integer(val, quantum_cycles);
+        }
+        else if (key == "quantum-min") { iss >> quantum_min; }
+        else if (key == "quantum-max") { iss >> quantum_max; }
+        else if (key == "quantum-target-switch") { iss >> quantum_target_switch; }
+        else if (key == "quantum-target-response") { iss >> quantum_target_response; }
+        else if (key == "batch-process-freq") { iss >> batch_process_freq; }
+        else if (key == "generator-threads") { iss >> generator_threads; }
+        else if (key == "prepare-threads") { iss >> prepare_threads; }
+        else if (key == "workload-profile") { iss >> workload_profile; }
+        else if (key == "program-cache-size") { iss >> program_cache_size; }
+        else if (key == "min-ins") { iss >> min_ins; }
+        else if (key == "max-ins") { iss >> max_ins; }
+        else if (key == "delay-per-exec") { iss >> delay_per_exec; }
+        else if (key == "max-overall-mem") { iss >> max_overall_mem; }
+        else if (key == "mem-per-frame") { iss >> mem_per_frame; }
+        else if (key == "min-mem-per-proc") { iss >> min_mem_per_proc; }
+        else if (key == "max-mem-per-proc") { iss >> max_mem_per_proc; }
+        else if (key == "max-committed-mem") { iss >> max_committed_mem; }
+        else if (key == "seed") { iss >> config_seed; }
+        else if (key == "aging-cycles") {
+            // Zero or negative would stop aging (and with it the starvation guard): keep the default
+            std::string val;
+            iss >> val;
+            int cycles = 0;
+            if (parse_integer(val, cycles) && cycles > 0) aging_cycles = static_cast<uint64_t>(cycles);
+        }
+        else if (key == "mlfq-levels") { iss >> mlfq_levels; }
+        else if (key == "mlfq-quanta") {
+            int q;
+            while (iss >> q) mlfq_quanta.push_back(q);
+        }
+        else if (key == "mlfq-boost-cycles") { iss >> mlfq_boost_cycles; }
+        else if (key == "cfs-target-latency") { iss >> cfs_target_latency; }
+        else if (key == "cfs-min-granularity") { iss >> cfs_min_granularity; }
+        else if (key == "affinity-window") { iss >> affinity_window; }
+        else if (key == "migration-cost") { iss >> migration_cost; }
+        else if (key == "virtual-time") {
+            std::string val;
+            iss >> val;
+            virtual_time = (val == "true" || val == "1" || val == "on");
+        }
+    }
+    return true;
+}
+
+bool initialize_from_config(const std::string& path) {
+    if (!load_config(path)) return false;
+
+    // Initialize memory manager with max_overall_mem (KB) converted to bytes
+    initializeMemory(max_overall_mem * 1024);
+    globalMemory->setCommitLimit(max_committed_mem);
+    process_archive.open();
+    seed_random(config_seed);
+    std::string error;
+    load_workload_profile(workload_profile, error); // a bad profile falls back to the built-in generator
+    clear_program_cache();
+    set_program_cache_capacity(program_cache_size);
+
+    initialized = true;
+    scheduler_start();
+    return true;
+}
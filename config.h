@@ -0,0 +1,12 @@
+#ifndef CSOPESY_CONFIG_H
+#define CSOPESY_CONFIG_H
+
+#include <string>
+
+// Reads config key/value lines into the globals; false if the file can't be opened
+bool load_config(const std::string& path);
+
+// load_config + memory manager, archive and scheduler start-up ('initialize')
+bool initialize_from_config(const std::string& path);
+
+#endif // CSOPESY_CONFIG_H
@@ -4,11 +4,33 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
+#include <vector>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
 #endif
 
+// Change notification: producers mark the frame dirty, the display thread wakes up
+static std::mutex display_event_mutex;
+static std::condition_variable display_event_cv;
+static bool display_dirty = true;
+
+std::atomic<uint64_t> display_bytes_written{0};
+std::atomic<uint64_t> display_bytes_per_sec{0};
+
+void notify_display() {
+    {
+        std::lock_guard<std::mutex> lock(display_event_mutex);
+        display_dirty = true;
+    }
+    display_event_cv.notify_one();
+}
+
 void clear_screen() {
 #ifdef _WIN32
     // Use Windows API to clear screen reliably
@@ -31,16 +53,100 @@ void clear_screen() {
 #else
     // Use ANSI escape codes for POSIX systems
     std::cout << "\033[2J\033[H" << std::flush;
+    display_bytes_written += 7;
+#endif
+}
+
+// Visible rows and columns of the terminal, 0 if unknown (e.g. output is not a terminal)
+static void terminal_size(size_t& rows, size_t& cols) {
+    rows = cols = 0;
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO csbi;
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    if (hConsole != INVALID_HANDLE_VALUE && GetConsoleScreenBufferInfo(hConsole, &csbi)) {
+        rows = static_cast<size_t>(csbi.srWindow.Bottom - csbi.srWindow.Top + 1);
+        cols = static_cast<size_t>(csbi.srWindow.Right - csbi.srWindow.Left + 1);
+    }
+#else
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0) {
+        rows = ws.ws_row;
+        cols = ws.ws_col;
+    }
 #endif
 }
 
+static void append_cursor_move(std::string& out, size_t row, size_t col) {
+    out += "\033[";
+    out += std::to_string(row + 1);
+    out += ';';
+    out += std::to_string(col + 1);
+    out += 'H';
+}
+
+// Escape sequences that turn `prev` into `next` on screen, touching only changed cells
+static void diff_frames(const std::vector<std::string>& prev, const std::vector<std::string>& next, std::string& out) {
+    size_t rows = std::max(prev.size(), next.size());
+    for (size_t r = 0; r < rows; ++r) {
+        if (r >= next.size()) {
+            // Row no longer part of the frame
+            append_cursor_move(out, r, 0);
+            out += "\033[2K";
+            continue;
+        }
+        const std::string& now = next[r];
+        const std::string empty;
+        const std::string& before = (r < prev.size()) ? prev[r] : empty;
+        if (now == before) continue;
+
+        size_t first = 0;
+        while (first < now.size() && first < before.size() && now[first] == before[first]) ++first;
+        size_t endNow = now.size(), endBefore = before.size();
+        while (endNow > first && endBefore > first && now[endNow - 1] == before[endBefore - 1]) { --endNow; --endBefore; }
+        // Lengths differ: rewrite the tail so shifted text lands in the right cells
+        if (now.size() != before.size()) endNow = now.size();
+
+        append_cursor_move(out, r, first);
+        out.append(now, first, endNow - first);
+        if (now.size() < before.size()) out += "\033[K";
+    }
+}
+
 void display_thread_func() {
-    const int refresh_rate_ms = 400; 
     const int display_width = 40;
-    std::string last_prompt_message; // cache to prevent redundant heavy redraws
-    size_t last_rendered_lines = 0;   // total lines last full render produced
-    bool last_was_heavy_panel = false;
+    const auto min_frame_interval = std::chrono::milliseconds(16); // coalesce bursts of events
+    const auto idle_refresh = std::chrono::milliseconds(1000);      // catch un-notified prompt changes
+
+    std::vector<std::string> prev_frame;
+    bool need_full_redraw = true;
+    size_t prev_cols = 0;
+    auto rate_window_start = std::chrono::steady_clock::now();
+    uint64_t rate_window_bytes = display_bytes_written.load();
+
     while (is_running) {
+        {
+            std::unique_lock<std::mutex> lock(display_event_mutex);
+            display_event_cv.wait_for(lock, idle_refresh, [] { return display_dirty || !is_running; });
+            display_dirty = false;
+        }
+        if (!is_running) break;
+
+        // Bytes/second over roughly one-second windows
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - rate_window_start).count();
+        if (elapsed >= 1000) {
+            uint64_t total = display_bytes_written.load();
+            display_bytes_per_sec = (total - rate_window_bytes) * 1000 / static_cast<uint64_t>(elapsed);
+            rate_window_bytes = total;
+            rate_window_start = now;
+        }
+
+        if (pause_display_refresh) {
+            // Someone else owns the terminal; repaint everything once they hand it back
+            need_full_redraw = true;
+            continue;
+        }
+
         std::string text_to_show;
         std::string prompt_message;
         std::string input_snapshot;
@@ -78,66 +184,64 @@ void display_thread_func() {
             input_snapshot = current_input;
         }
 
-        // Decide if the current prompt content is a heavy multi-line static panel
-        bool is_heavy_panel = (prompt_message.find("PROCESS-SMI") != std::string::npos) ||
-                              (prompt_message.find("VMSTAT") != std::string::npos);
-        bool prompt_changed = (prompt_message != last_prompt_message);
+        // Build the new frame, one string per screen row
+        std::vector<std::string> frame;
+        frame.push_back("=========  OS Marquee Emulator  ========");
+        frame.push_back("");
+        frame.push_back(text_to_show);
+        frame.push_back("");
+        frame.push_back("Type 'help' for commands.");
+        frame.push_back("");
+        size_t start = 0;
+        while (true) {
+            size_t nl = prompt_message.find('\n', start);
+            frame.push_back(prompt_message.substr(start, nl == std::string::npos ? std::string::npos : nl - start));
+            if (nl == std::string::npos) break;
+            start = nl + 1;
+        }
+        frame.push_back("root:\\> " + input_snapshot);
 
-        // Only clear and redraw fully if:
-        //  - not paused AND
-        //  - prompt changed OR not heavy panel (marquee/status updates)
-        if (!pause_display_refresh && (prompt_changed || !is_heavy_panel)) {
-            clear_screen();
-            std::cout << "=========  OS Marquee Emulator  ========\n\n";
-            std::cout << text_to_show << "\n\n";
-            std::cout << "Type 'help' for commands.\n\n";
-            std::cout << prompt_message << "\n";
-            std::cout << "root:\\> " << input_snapshot << std::flush;
-            last_prompt_message = prompt_message; // update cache after redraw
-            // Approximate line count for cursor math
-            size_t panel_lines = 0;
-            panel_lines += 2; // header + blank
-            panel_lines += 2; // marquee + blank
-            panel_lines += 2; // help + blank
-            // count lines inside prompt_message
-            panel_lines += 1; // at least one line
-            for (char c : prompt_message) if (c == '\n') panel_lines++;
-            panel_lines += 1; // prompt line itself
-            last_rendered_lines = panel_lines;
-            last_was_heavy_panel = is_heavy_panel;
+        // Rows wider than the terminal wrap onto extra lines, and frames taller than
+        // it scroll; either way cursor addressing would miss, so repaint in full.
+        // A resize reflows what is already on screen, so it repaints once too.
+        size_t rows = 0, cols = 0;
+        terminal_size(rows, cols);
+        if (cols != prev_cols) need_full_redraw = true;
+        prev_cols = cols;
+        bool wraps = false;
+        size_t screen_rows = frame.size();
+        if (cols > 0) {
+            for (const auto& row : frame) {
+                if (row.size() <= cols) continue;
+                wraps = true;
+                screen_rows += (row.size() - 1) / cols;
+            }
         }
-        // If heavy panel unchanged, do not redraw entire panel, only update input line so user can type.
-        else if (!pause_display_refresh && is_heavy_panel && !prompt_changed) {
-            // Update just the prompt/input line in place.
-#ifdef _WIN32
-            HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-            if (hConsole != INVALID_HANDLE_VALUE) {
-                // Move cursor to start of prompt line (last_rendered_lines - 1)
-                CONSOLE_SCREEN_BUFFER_INFO csbi; 
-                if (GetConsoleScreenBufferInfo(hConsole, &csbi)) {
-                    SHORT targetRow = (SHORT)std::min((int)csbi.dwSize.Y - 1, (int)(last_rendered_lines - 1));
-                    COORD pos {0, targetRow};
-                    SetConsoleCursorPosition(hConsole, pos);
-                    // Clear the line then rewrite
-                    DWORD written; 
-                    std::string clearLine(csbi.dwSize.X, ' ');
-                    WriteConsoleOutputCharacterA(hConsole, clearLine.c_str(), (DWORD)clearLine.size(), pos, &written);
-                    SetConsoleCursorPosition(hConsole, pos);
-                    std::cout << "root:\\> " << input_snapshot << std::flush;
-                }
+        bool too_tall = rows > 0 && screen_rows > rows;
+        if ((too_tall || wraps) && frame == prev_frame && !need_full_redraw) continue;
+
+        std::string out;
+        if (need_full_redraw || too_tall || wraps) {
+            clear_screen();
+            for (size_t i = 0; i < frame.size(); ++i) {
+                out += frame[i];
+                if (i + 1 < frame.size()) out += '\n';
             }
-#else
-            // POSIX: Move cursor to line and clear then rewrite (1-based coordinates)
-            size_t targetRow = last_rendered_lines; // prompt line approx
-            std::cout << "\033[" << targetRow << ";1H"; // move
-            std::cout << "\033[2K"; // clear line
-            std::cout << "root:\\> " << input_snapshot << std::flush;
-#endif
+            need_full_redraw = false;
+        } else {
+            diff_frames(prev_frame, frame, out);
+            if (out.empty()) continue; // nothing changed on screen
+            // Park the cursor after the typed input
+            append_cursor_move(out, frame.size() - 1, frame.back().size());
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(refresh_rate_ms));
+        std::cout << out << std::flush;
+        display_bytes_written += out.size();
+        prev_frame = std::move(frame);
+
+        std::this_thread::sleep_for(min_frame_interval);
     }
 
     // When leaving the loop, print a final newline so terminal prompt looks clean
     std::cout << std::endl;
-}
\ No newline at end of file
+}
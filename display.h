@@ -1,5 +1,12 @@
 // display.h
 #ifndef DISPLAY_H
 #define DISPLAY_H
+#include <atomic>
+#include <cstdint>
 void display_thread_func();
-#endif
\ No newline at end of file
+// Wakes the display thread to render a new frame (marquee, input or prompt changed)
+void notify_display();
+// Terminal output accounting
+extern std::atomic<uint64_t> display_bytes_written;
+extern std::atomic<uint64_t> display_bytes_per_sec;
+#endif
@@ -1,4 +1,7 @@
 #include "globals.h"
+#include "display.h"
+#include "keyboard.h"
+#include <chrono>
 
 // --- Shared State and Thread Control ---
 std::atomic<bool> is_running{true};   // Global flag to signal threads to exit
@@ -12,6 +15,60 @@ std::mutex prompt_mutex;
 // Queue of commands (from keyboard to command interpreter)
 std::queue<std::string> command_queue;
 std::mutex command_queue_mutex;
+std::condition_variable command_cv;
+uint64_t input_version = 0;
+std::atomic<bool> headless_mode{false};
+
+void enqueue_command(const std::string& line) {
+    {
+        std::unique_lock<std::mutex> lock(command_queue_mutex);
+        command_queue.push(line);
+    }
+    command_cv.notify_all();
+}
+
+void notify_input_changed() {
+    {
+        std::unique_lock<std::mutex> lock(command_queue_mutex);
+        input_version++;
+    }
+    command_cv.notify_all();
+}
+
+static bool input_closed = false; // guarded by command_queue_mutex
+
+void close_command_input() {
+    {
+        std::unique_lock<std::mutex> lock(command_queue_mutex);
+        input_closed = true;
+    }
+    command_cv.notify_all();
+}
+
+bool command_input_closed() {
+    std::unique_lock<std::mutex> lock(command_queue_mutex);
+    return input_closed;
+}
+
+bool wait_for_command(std::string& line) {
+    std::unique_lock<std::mutex> lock(command_queue_mutex);
+    // The timeout only matters for shutdown via SIGINT, which cannot notify
+    while (command_queue.empty() && is_running && !input_closed) {
+        command_cv.wait_for(lock, std::chrono::seconds(1));
+    }
+    if (command_queue.empty()) return false;
+    line = command_queue.front();
+    command_queue.pop();
+    return true;
+}
+
+void request_shutdown() {
+    is_running = false;
+    { std::unique_lock<std::mutex> lock(command_queue_mutex); }
+    command_cv.notify_all();
+    notify_display();
+    wake_keyboard_thread();
+}
 
 // Marquee state shared between logic + display
 std::string marquee_text = "Welcome to CSOPESY!";
@@ -33,7 +90,16 @@ std::mutex input_mutex;
 int num_cpu = 4;
 std::string scheduler_type = "fcfs";
 int quantum_cycles = 5;
+bool quantum_auto = false;
+int quantum_min = 1;
+int quantum_max = 64;
+double quantum_target_switch = 10.0;
+int quantum_target_response = 200;
 int batch_process_freq = 1;
+int generator_threads = 2;
+int prepare_threads = 2;
+std::string workload_profile;
+size_t program_cache_size = 64;
 int min_ins = 1000;
 int max_ins = 2000;
 int delay_per_exec = 0;
@@ -41,11 +107,22 @@ size_t max_overall_mem = 4096;      // Default 4GB in MiB
 size_t mem_per_frame = 4;            // Default 4KB page size (in KB)
 size_t min_mem_per_proc = 64;        // Minimum 64 bytes per process
 size_t max_mem_per_proc = 256;       // Maximum 256 bytes per process
+size_t max_committed_mem = 0;        // Unlimited
+uint64_t config_seed = 0;
+SchedulerPolicy scheduler_policy = SchedulerPolicy::FCFS;
+uint64_t aging_cycles = 200;
+int mlfq_levels = 3;
+std::vector<int> mlfq_quanta;
+uint64_t mlfq_boost_cycles = 1000;
+int cfs_target_latency = 48;
+int cfs_min_granularity = 2;
+int affinity_window = 4;
+int migration_cost = 0;
+bool virtual_time = false;
 
 // Process management definitions
-std::unordered_map<std::string, std::shared_ptr<ProcessControlBlock>> process_table;
-std::vector<std::shared_ptr<ProcessControlBlock>> finished_processes;
-std::queue<std::shared_ptr<ProcessControlBlock>> ready_queue;
+std::vector<std::shared_ptr<const RetiredProcess>> finished_processes;
+ReadyQueue ready_queue;
 std::mutex process_table_mutex;
 std::condition_variable ready_cv;
 bool initialized = false;
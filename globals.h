@@ -9,9 +9,12 @@
 #include <vector>
 #include <memory>
 #include <condition_variable>
+#include <cstdint>
+#include "ready_queue.h"
 
 // Forward declarations
 struct ProcessControlBlock;
+struct RetiredProcess;
 
 // Global flags
 extern std::atomic<bool> is_running;
@@ -34,12 +37,43 @@ extern std::mutex input_mutex;
 
 // Command queue
 extern std::queue<std::string> command_queue;
+extern std::condition_variable command_cv;   // new command, input edit, or shutdown
+extern uint64_t input_version;                // bumped on every keystroke (guarded by command_queue_mutex)
+extern std::atomic<bool> headless_mode;       // commands come from a script/pipe, no TUI
+
+void enqueue_command(const std::string& line);
+void notify_input_changed();
+// No more commands will arrive (end of script or stdin closed)
+void close_command_input();
+bool command_input_closed();
+// Blocks until a command is available; returns false on shutdown or once input is closed and drained
+bool wait_for_command(std::string& line);
+// Clears is_running and wakes every thread blocked on an event
+void request_shutdown();
 
 // config.txt parameters
 extern int num_cpu;
 extern std::string scheduler_type;
+extern SchedulerPolicy scheduler_policy; // parsed from scheduler_type by load_config
+extern uint64_t aging_cycles;            // priority scheduler: cycles of waiting worth one priority level
+extern int mlfq_levels;                  // MLFQ: number of queue levels
+extern std::vector<int> mlfq_quanta;     // MLFQ: quantum per level (missing levels double the previous one)
+extern uint64_t mlfq_boost_cycles;       // MLFQ: cycles between boosts back to the top level (0 = never)
+extern int cfs_target_latency;           // CFS: instructions in which every runnable process gets a turn (per core)
+extern int cfs_min_granularity;          // CFS: shortest slice however many processes are runnable
+extern int affinity_window;              // queued processes a core may skip to find one it ran last (0 = no affinity)
+extern int migration_cost;               // ticks a core spends before running a process that last ran elsewhere
 extern int quantum_cycles;
+extern bool quantum_auto;                // 'quantum-cycles auto': the tuner picks the quantum
+extern int quantum_min;                  // auto quantum bounds
+extern int quantum_max;
+extern double quantum_target_switch;     // auto: context switches per 100 instructions to aim for
+extern int quantum_target_response;      // auto: max estimated ready-queue wait in ticks (0 = ignore)
 extern int batch_process_freq;
+extern int generator_threads;            // scheduler-test: threads building processes in parallel
+extern int prepare_threads;              // threads flattening programs before admission (threaded mode)
+extern std::string workload_profile;     // generator profile file ("" = built-in instruction cycle)
+extern size_t program_cache_size;       // compiled programs kept for reuse by identical submissions (0 = off)
 extern int min_ins;
 extern int max_ins;
 extern int delay_per_exec;
@@ -47,12 +81,14 @@ extern size_t max_overall_mem;      // Maximum overall memory (e.g., 4096 for 4G
 extern size_t mem_per_frame;         // Memory per frame (page size)
 extern size_t min_mem_per_proc;      // Minimum memory per process
 extern size_t max_mem_per_proc;      // Maximum memory per process
+extern size_t max_committed_mem;     // Bytes of process memory that may be allocated at once (0 = unlimited)
+extern uint64_t config_seed;         // 0 = fresh random seed each initialize
+extern bool virtual_time;            // deterministic single-threaded simulation
 
 // process management
-extern std::unordered_map<std::string, std::shared_ptr<ProcessControlBlock>> process_table;
-extern std::vector<std::shared_ptr<ProcessControlBlock>> finished_processes;
-extern std::queue<std::shared_ptr<ProcessControlBlock>> ready_queue;
-extern std::mutex process_table_mutex;
+extern std::vector<std::shared_ptr<const RetiredProcess>> finished_processes; // compact records, logs in the archive
+extern ReadyQueue ready_queue;
+extern std::mutex process_table_mutex; // guards ready_queue and finished_processes (lookups go through process_registry)
 extern std::condition_variable ready_cv;
 extern bool initialized;
 extern std::atomic<int> cpuCycles;
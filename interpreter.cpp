@@ -3,6 +3,21 @@
 #include "utils.h"
 #include "process.h"
 #include "memory.h"
+#include "registry.h"
+#include "archive.h"
+#include "report.h"
+#include "snapshot.h"
+#include "display.h"
+#include "config.h"
+#include "trace.h"
+#include "metrics.h"
+#include "rng.h"
+#include "tuner.h"
+#include "workload.h"
+#include "replay.h"
+#include "parser.h"
+#include "program_cache.h"
+#include "admission.h"
 #include <thread>
 #include <chrono>
 #include <fstream>
@@ -16,17 +31,138 @@ void scheduler_test();
 void scheduler_stop();
 bool is_scheduler_active();
 std::shared_ptr<ProcessControlBlock> generate_random_process(size_t memorySize = 256);
+bool edf_admit(const ProcessControlBlock& pcb, std::string& error);
+int online_core_count();
+bool scheduler_set_cores(int count, std::string& message);
+std::string format_core_phases();
+
+// Optional flags accepted after the memory size of screen -s / screen -c
+struct ProcessOptions {
+    int priority = DEFAULT_PRIORITY;
+    int nice = 0;
+    uint64_t rtPeriod = 0;     // -rt <period> <deadline>: EDF real-time class
+    uint64_t rtDeadline = 0;
+    int rtJobs = 1;            // -jobs <n>
+};
+
+// Parses flags starting at tokens[first]; `next` is the first token that is not a flag
+static bool parse_process_options(const std::vector<std::string>& tokens, size_t first, ProcessOptions& opts,
+                                  size_t& next, std::string& error) {
+    next = first;
+    while (next < tokens.size()) {
+        if (tokens[next] == "-p") {
+            int value = 0;
+            if (next + 1 >= tokens.size() || !parse_integer(tokens[next + 1], value) || value < 0 ||
+                value >= NUM_PRIORITY_LEVELS) {
+                error = "invalid priority (0-" + std::to_string(NUM_PRIORITY_LEVELS - 1) + ", 0 is most urgent)";
+                return false;
+            }
+            opts.priority = value;
+            next += 2;
+        } else if (tokens[next] == "-n") {
+            int value = 0;
+            if (next + 1 >= tokens.size() || !parse_integer(tokens[next + 1], value) || value < -20 || value > 19) {
+                error = "invalid nice value (-20 to 19, lower gets more cpu)";
+                return false;
+            }
+            opts.nice = value;
+            next += 2;
+        } else if (tokens[next] == "-rt") {
+            int period = 0;
+            int deadline = 0;
+            if (next + 2 >= tokens.size() || !parse_integer(tokens[next + 1], period) ||
+                !parse_integer(tokens[next + 2], deadline) || period <= 0 || deadline <= 0) {
+                error = "invalid real-time parameters (-rt <period> <deadline>, in cpu ticks)";
+                return false;
+            }
+            opts.rtPeriod = static_cast<uint64_t>(period);
+            opts.rtDeadline = static_cast<uint64_t>(deadline);
+            next += 3;
+        } else if (tokens[next] == "-jobs") {
+            int value = 0;
+            if (next + 1 >= tokens.size() || !parse_integer(tokens[next + 1], value) || value <= 0) {
+                error = "invalid job count";
+                return false;
+            }
+            opts.rtJobs = value;
+            next += 2;
+        } else {
+            break;
+        }
+    }
+    return true;
+}
+
+// Copies parsed options onto a new process; real-time processes must pass EDF admission
+static bool apply_process_options(ProcessControlBlock& pcb, const ProcessOptions& opts, std::string& error) {
+    pcb.priority = opts.priority;
+    pcb.nice = opts.nice;
+    if (opts.rtPeriod == 0) return true;
+    if (scheduler_policy != SchedulerPolicy::EDF) {
+        error = "real-time processes (-rt) need scheduler \"edf\"";
+        return false;
+    }
+    pcb.rtPeriod = opts.rtPeriod;
+    pcb.rtDeadline = opts.rtDeadline;
+    pcb.rtJobs = opts.rtJobs;
+    return edf_admit(pcb, error);
+}
+
+// Reserves memory for a new interactive process and makes it ready; returns the
+// message for the prompt (`created` on success)
+static std::string admit_user_process(const std::shared_ptr<ProcessControlBlock>& pcb, const std::string& created) {
+    std::string error;
+    if (!admission_possible(pcb->process->memorySize, error)) {
+        return "Process " + pcb->process->name + " rejected: " + error;
+    }
+    if (globalMemory && !globalMemory->allocateProcess(pcb->process->pid, pcb->process->memorySize)) {
+        return "Failed to allocate memory for process " + pcb->process->name;
+    }
+
+    process_registry.add(pcb);
+    capture_process(*pcb);
+    {
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        ready_queue.push(pcb);
+    }
+    ready_cv.notify_one();
+    return created;
+}
+
+// Creates a process running `program` (screen -c / screen -f) and makes it
+// ready; returns the message for the prompt
+static std::string submit_user_process(const std::string& name, size_t memSize, const ProcessOptions& opts,
+                                       std::shared_ptr<const CompiledProgram> program) {
+    size_t count = program->instructions.size();
+    auto pcb = std::make_shared<ProcessControlBlock>();
+    pcb->process = std::make_unique<Process>();
+    pcb->process->pid = generate_pid();
+    pcb->process->name = name;
+    pcb->setProgram(std::move(program));
+    pcb->process->memorySize = memSize;
+    pcb->initializeMemory(memSize);
+    std::string error;
+    if (!apply_process_options(*pcb, opts, error)) return error; // rejected (e.g. by EDF admission) before any memory is reserved
+    return admit_user_process(pcb, "Process " + name + " created with " + std::to_string(count) +
+                                       " user-defined instructions.");
+}
+
+// Offset in `line` just past tokens[index] (tokens are matched in order)
+static size_t token_end(const std::string& line, const std::vector<std::string>& tokens, size_t index) {
+    size_t pos = 0;
+    for (size_t i = 0; i <= index && i < tokens.size(); ++i) {
+        pos = line.find(tokens[i], pos);
+        if (pos == std::string::npos) return line.size();
+        pos += tokens[i].size();
+    }
+    return pos;
+}
 
 void command_interpreter_thread_func() {
+    rng_bind_stream(RNG_STREAM_INTERPRETER);
     while (is_running) {
         std::string command_line;
-        {
-            std::unique_lock<std::mutex> lock(command_queue_mutex);
-            if (!command_queue.empty()) {
-                command_line = command_queue.front();
-                command_queue.pop();
-            }
-        }
+        if (!wait_for_command(command_line)) break; // sleeps until a command arrives
 
         if (!command_line.empty()) {
             std::vector<std::string> tokens = split_string(command_line);
@@ -35,44 +171,15 @@ void command_interpreter_thread_func() {
 
             // Initialize command
             if (command == "initialize") {
-                std::ifstream ifs("config.txt");
-                if (!ifs) {
+                if (!initialize_from_config("config.txt")) {
                     std::unique_lock<std::mutex> lock(prompt_mutex);
                     prompt_display_buffer = "Failed to open config.txt";
                 } else {
-                    std::string line;
-                    while (std::getline(ifs, line)) {
-                        std::istringstream iss(line);
-                        std::string key;
-                        iss >> key;
-                        
-                        if (key == "num-cpu") { iss >> num_cpu; }
-                        else if (key == "scheduler") { 
-                            std::string val; 
-                            iss >> val;
-                            // Remove quotes if present
-                            if (val.front() == '"') val = val.substr(1);
-                            if (val.back() == '"') val = val.substr(0, val.size()-1);
-                            scheduler_type = val;
-                        }
-                        else if (key == "quantum-cycles") { iss >> quantum_cycles; }
-                        else if (key == "batch-process-freq") { iss >> batch_process_freq; }
-                        else if (key == "min-ins") { iss >> min_ins; }
-                        else if (key == "max-ins") { iss >> max_ins; }
-                        else if (key == "delay-per-exec") { iss >> delay_per_exec; }
-                        else if (key == "max-overall-mem") { iss >> max_overall_mem; }
-                        else if (key == "mem-per-frame") { iss >> mem_per_frame; }
-                        else if (key == "min-mem-per-proc") { iss >> min_mem_per_proc; }
-                        else if (key == "max-mem-per-proc") { iss >> max_mem_per_proc; }
-                    }
-                    
-                    // Initialize memory manager with max_overall_mem (KB) converted to bytes
-                    initializeMemory(max_overall_mem * 1024);
-                    
-                    initialized = true;
-                    scheduler_start();
                     std::unique_lock<std::mutex> lock(prompt_mutex);
-                    prompt_display_buffer = "Initialized with " + std::to_string(num_cpu) + " CPUs, scheduler: " + scheduler_type;
+                    prompt_display_buffer = "Initialized with " + std::to_string(num_cpu) + " CPUs, scheduler: " + scheduler_type +
+                                            ", seed: " + std::to_string(current_seed()) + (virtual_time ? " (virtual time)" : "");
+                    std::string workload = describe_workload();
+                    if (!workload.empty()) prompt_display_buffer += "\n" + workload;
                 }
             }
             // Check if initialized before allowing other commands
@@ -84,13 +191,20 @@ void command_interpreter_thread_func() {
             else if (command == "screen") {
                 if (tokens.size() > 1) {
                     if (tokens[1] == "-s" && tokens.size() > 3) {
-                        // screen -s <process_name> <process_memory_size>
+                        // screen -s <process_name> <process_memory_size> [-p <priority>] [-n <nice>]
                         std::string pname = tokens[2];
                         std::string pmemsize_str = tokens[3];
+                        ProcessOptions opts;
+                        size_t next = 0;
+                        std::string optError;
                         
                         // Parse memory size
                         int pmemsize_int = 0;
-                        if (!parse_integer(pmemsize_str, pmemsize_int) || pmemsize_int < 0) {
+                        if (!parse_process_options(tokens, 4, opts, next, optError) || next != tokens.size()) {
+                            std::unique_lock<std::mutex> lock(prompt_mutex);
+                            prompt_display_buffer = optError.empty() ? "Usage: screen -s <name> <mem_size> [-p <priority>] [-n <nice>]" : optError;
+                        }
+                        else if (!parse_integer(pmemsize_str, pmemsize_int) || pmemsize_int < 0) {
                             std::unique_lock<std::mutex> lock(prompt_mutex);
                             prompt_display_buffer = "invalid memory allocation";
                         }
@@ -106,24 +220,14 @@ void command_interpreter_thread_func() {
                                 // Valid memory size, create process
                                 auto pcb = generate_random_process(pmemsize);
                                 pcb->process->name = pname;
-                                
-                                // Allocate memory for the process
-                                if (globalMemory) {
-                                    if (!globalMemory->allocateProcess(pcb->process->pid, pmemsize)) {
-                                        std::unique_lock<std::mutex> lock(prompt_mutex);
-                                        prompt_display_buffer = "Failed to allocate memory for process " + pname;
-                                        continue;
-                                    }
-                                }
-                                
-                                {
-                                    std::unique_lock<std::mutex> lock(process_table_mutex);
-                                    process_table[pname] = pcb;
-                                    ready_queue.push(pcb);
+                                prepare_process(*pcb);
+                                std::string message;
+                                if (apply_process_options(*pcb, opts, message)) { // otherwise rejected (e.g. by EDF admission)
+                                    message = admit_user_process(pcb, "Process " + pname + " created with " +
+                                                                          std::to_string(pmemsize) + " bytes.");
                                 }
-                                ready_cv.notify_one();
                                 std::unique_lock<std::mutex> lock(prompt_mutex);
-                                prompt_display_buffer = "Process " + pname + " created with " + std::to_string(pmemsize) + " bytes.";
+                                prompt_display_buffer = message;
                             }
                         }
                     }
@@ -132,51 +236,45 @@ void command_interpreter_thread_func() {
                         std::string pname = tokens[2];
                         auto pcb = generate_random_process(256);  // Default 256 bytes
                         pcb->process->name = pname;
-                        
-                        // Allocate memory for the process
-                        if (globalMemory) {
-                            if (!globalMemory->allocateProcess(pcb->process->pid, 256)) {
-                                std::unique_lock<std::mutex> lock(prompt_mutex);
-                                prompt_display_buffer = "Failed to allocate memory for process " + pname;
-                                continue;
-                            }
-                        }
-                        
-                        {
-                            std::unique_lock<std::mutex> lock(process_table_mutex);
-                            process_table[pname] = pcb;
-                            ready_queue.push(pcb);
-                        }
-                        ready_cv.notify_one();
+                        prepare_process(*pcb);
+                        std::string message = admit_user_process(pcb, "Process " + pname + " created with 256 bytes (default).");
                         std::unique_lock<std::mutex> lock(prompt_mutex);
-                        prompt_display_buffer = "Process " + pname + " created with 256 bytes (default).";
+                        prompt_display_buffer = message;
                     }
-                    else if (tokens[1] == "-c" && tokens.size() > 3) {
-                        // screen -c <process_name> <memory_size> "<instructions>"
+                    else if ((tokens[1] == "-c" || tokens[1] == "-f") && tokens.size() > 3) {
+                        // screen -c <process_name> <memory_size> [-p <priority>] [-n <nice>] [-rt <period> <deadline> [-jobs <n>]] "<instructions>"
+                        // screen -f <process_name> <memory_size> [same flags] <program_file>
+                        bool fromFile = tokens[1] == "-f";
                         std::string pname = tokens[2];
                         std::string pmemsize_str = tokens[3];
+                        ProcessOptions opts;
+                        size_t next = 0;
+                        std::string optError;
+                        std::string message;
                         
                         // Parse memory size
                         int pmemsize_int = 0;
-                        if (!parse_integer(pmemsize_str, pmemsize_int) || pmemsize_int < 0) {
-                            std::unique_lock<std::mutex> lock(prompt_mutex);
-                            prompt_display_buffer = "invalid memory allocation";
+                        if (!parse_process_options(tokens, 4, opts, next, optError)) {
+                            message = optError;
+                        }
+                        else if (!parse_integer(pmemsize_str, pmemsize_int) || pmemsize_int < 0 ||
+                                 !is_valid_memory_size(static_cast<size_t>(pmemsize_int))) {
+                            message = "invalid memory allocation";
+                        }
+                        else if (fromFile && next + 1 != tokens.size()) {
+                            message = "Usage: screen -f <name> <mem_size> [-p <prio>] [-n <nice>] <program_file>";
                         }
                         else {
-                            size_t pmemsize = static_cast<size_t>(pmemsize_int);
-                            
-                            // Validate memory size
-                            if (!is_valid_memory_size(pmemsize)) {
-                                std::unique_lock<std::mutex> lock(prompt_mutex);
-                                prompt_display_buffer = "invalid memory allocation";
-                            }
-                            else {
-                                // Extract instruction string (everything after memory size, may be quoted)
-                                std::string instructionStr;
-                                size_t pos = command_line.find(tokens[3]);
-                                if (pos != std::string::npos) {
-                                    pos += tokens[3].length();
-                                    instructionStr = command_line.substr(pos);
+                            std::shared_ptr<const CompiledProgram> program;
+                            ParseError parseError;
+                            if (fromFile) {
+                                program = compile_program_file(tokens[next], parseError);
+                            } else {
+                                // Instruction string: everything after memory size and flags, may be quoted
+                                std::string_view instructionStr;
+                                size_t pos = token_end(command_line, tokens, next - 1);
+                                if (pos < command_line.size()) {
+                                    instructionStr = std::string_view(command_line).substr(pos);
                                     // Trim leading/trailing whitespace and quotes
                                     size_t start = instructionStr.find_first_not_of(" \t\"");
                                     size_t end = instructionStr.find_last_not_of(" \t\"");
@@ -184,105 +282,89 @@ void command_interpreter_thread_func() {
                                         instructionStr = instructionStr.substr(start, end - start + 1);
                                     }
                                 }
-                                
-                                // Parse user instructions
-                                std::vector<Instruction> userInstructions = parseUserInstructions(instructionStr);
-                                
-                                // Validate instruction count (1-50)
-                                if (userInstructions.empty() || userInstructions.size() > 50) {
-                                    std::unique_lock<std::mutex> lock(prompt_mutex);
-                                    prompt_display_buffer = "invalid command";
-                                }
-                                else {
-                                    // Create process with user-defined instructions
-                                    auto pcb = std::make_shared<ProcessControlBlock>();
-                                    pcb->process = std::make_unique<Process>();
-                                    pcb->process->pid = generate_pid();
-                                    pcb->process->name = pname;
-                                    pcb->process->instructions = userInstructions;
-                                    pcb->process->memorySize = pmemsize;
-                                    pcb->initializeMemory(pmemsize);
-                                    
-                                    // Allocate memory for the process
-                                    if (globalMemory) {
-                                        if (!globalMemory->allocateProcess(pcb->process->pid, pmemsize)) {
-                                            std::unique_lock<std::mutex> lock(prompt_mutex);
-                                            prompt_display_buffer = "Failed to allocate memory for process " + pname;
-                                            continue;
-                                        }
-                                    }
-                                    
-                                    {
-                                        std::unique_lock<std::mutex> lock(process_table_mutex);
-                                        process_table[pname] = pcb;
-                                        ready_queue.push(pcb);
-                                    }
-                                    ready_cv.notify_one();
-                                    std::unique_lock<std::mutex> lock(prompt_mutex);
-                                    prompt_display_buffer = "Process " + pname + " created with " + 
-                                                           std::to_string(userInstructions.size()) + " user-defined instructions.";
-                                }
+                                program = compile_program(instructionStr, parseError);
+                            }
+                            
+                            if (!program) {
+                                message = "invalid program: " + parseError.describe();
+                            }
+                            // screen -c programs: 1-50 instructions; files have no upper limit
+                            else if (program->instructions.empty() || (!fromFile && program->instructions.size() > 50)) {
+                                message = "invalid command";
+                            }
+                            else {
+                                message = submit_user_process(pname, static_cast<size_t>(pmemsize_int), opts,
+                                                              std::move(program));
                             }
                         }
+                        std::unique_lock<std::mutex> lock(prompt_mutex);
+                        prompt_display_buffer = message;
                     }
                     else if (tokens[1] == "-ls") {
                         // Pause auto-refresh so user can scroll through the list
                         pause_display_refresh = true;
                         
                         std::ostringstream oss;
-                        int cores_used = 0;
-                        int cores_available = num_cpu;
+                        auto snap = latest_snapshot();
                         
                         {
-                            std::unique_lock<std::mutex> lock(process_table_mutex);
+                            // Scheduler-stopped snapshots report 0 cores used
+                            int cores_used = snap->coresUsed;
+                            int cores_available = snap->numCpu - cores_used;
                             
-                            // If scheduler is stopped, CPU utilization is 0%
-                            if (!is_scheduler_active()) {
-                                cores_used = 0;
-                                cores_available = num_cpu;
-                            } else {
-                                cores_used = active_cores.load();
-                                cores_available = num_cpu - cores_used;
-                            }
-                            
-                            oss << "CPU utilization: " << (cores_used * 100 / std::max(1, num_cpu)) << "%\n";
+                            oss << "CPU utilization: " << (cores_used * 100 / std::max(1, snap->numCpu)) << "%\n";
                             oss << "Cores used: " << cores_used << "\n";
-                            oss << "Cores available: " << cores_available << "\n\n";
-                            oss << "Running processes:\n";
+                            oss << "Cores available: " << cores_available << "\n";
+                            if (snap->pendingAdmissions > 0) {
+                                oss << "Pending admission: " << snap->pendingAdmissions << " (waiting for memory or program preparation)\n";
+                            }
+                            if (!snap->readyLevels.empty()) {
+                                oss << "Ready queue levels:";
+                                for (size_t level = 0; level < snap->readyLevels.size(); ++level) {
+                                    oss << "  L" << level << "=" << snap->readyLevels[level];
+                                }
+                                oss << "\n";
+                            }
+                            bool fair = scheduler_policy == SchedulerPolicy::CFS;
+                            if (fair) {
+                                oss << "Fairness (Jain index of weighted cpu share): " << std::fixed
+                                    << std::setprecision(3) << snap->fairnessIndex << "\n";
+                            }
+                            oss << "\nRunning processes:\n";
                             
-                            for (auto &kv : process_table) {
-                                auto &pcb = kv.second;
-                                oss << pcb->process->name << "    ";
-                                oss << get_timestamp() << "    ";
-                                oss << "Core: " << (pcb->process->pid % num_cpu) << "    ";
-                                int total_lines = pcb->flattenedInstructions.empty() ? pcb->process->instructions.size() : pcb->flattenedInstructions.size();
-                                oss << pcb->programCounter << " / " << total_lines << "\n";
+                            for (auto &view : snap->running) {
+                                oss << view.name << "    ";
+                                oss << view.arrivalTime << "    ";
+                                oss << "Core: " << (view.core >= 0 ? std::to_string(view.core) : "-") << "    ";
+                                oss << view.programCounter << " / " << view.totalLines;
+                                if (fair) {
+                                    oss << "    nice " << view.nice << "  vruntime " << view.vruntime
+                                        << "  share " << std::setprecision(2) << view.cpuShare;
+                                }
+                                if (view.realtime) {
+                                    oss << "    rt jobs " << view.rtJobsDone << "/" << view.rtJobs << "  missed "
+                                        << view.deadlineMisses << "  max late " << view.maxLateness;
+                                }
+                                oss << "\n";
                             }
                             
                             oss << "\nFinished processes:\n";
-                            for (auto &f : finished_processes) {
-                                oss << f->process->name << "    ";
-                                oss << get_timestamp() << "    ";
+                            for (auto &f : finished_records(*snap)) {
+                                oss << f->name << "    ";
+                                oss << f->finishTime << "    ";
                                 oss << "Finished    ";
-                                oss << f->flattenedInstructions.size() << " / " << f->flattenedInstructions.size() << "\n";
+                                oss << f->instructionsExecuted << " / " << f->totalInstructions << "\n";
                             }
                         }
                         
                         // Print directly to console since display refresh is paused
                         std::cout << "\n" << oss.str() << "\n";
-                        std::cout << "Press any key to return to main menu..." << std::flush;
-                        
-                        // Wait for user input before returning
-                        {
-                            std::unique_lock<std::mutex> qlock(command_queue_mutex);
-                            while (command_queue.empty() && is_running) {
-                                qlock.unlock();
-                                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                                qlock.lock();
-                            }
-                            if (!command_queue.empty()) {
-                                command_queue.pop(); // consume the keypress
-                            }
+                        if (!headless_mode) {
+                            std::cout << "Press any key to return to main menu..." << std::flush;
+                            
+                            // Wait for user input before returning (consumes the keypress)
+                            std::string keypress;
+                            wait_for_command(keypress);
                         }
                         
                         // Resume auto-refresh when returning to main menu
@@ -292,35 +374,21 @@ void command_interpreter_thread_func() {
                     }
                     else if (tokens[1] == "-r" && tokens.size() > 2) {
                         std::string pname = tokens[2];
-                        std::shared_ptr<ProcessControlBlock> pcb;
-                        bool foundInFinished = false;
+                        // Live processes first, then finished ones (summary + archived logs)
+                        std::shared_ptr<ProcessControlBlock> pcb = process_registry.findByName(pname);
+                        std::shared_ptr<const RetiredProcess> retired = pcb ? nullptr : process_registry.findRetired(pname);
+                        bool violation = pcb ? pcb->hasMemoryViolation : (retired && retired->hasMemoryViolation);
                         
-                        {
-                            std::unique_lock<std::mutex> lock(process_table_mutex);
-                            auto it = process_table.find(pname);
-                            if (it != process_table.end()) {
-                                pcb = it->second;
-                            } else {
-                                // Check if in finished processes
-                                for (const auto& fp : finished_processes) {
-                                    if (fp->process->name == pname) {
-                                        pcb = fp;
-                                        foundInFinished = true;
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                        
-                        if (!pcb) {
+                        if (!pcb && !retired) {
                             std::unique_lock<std::mutex> lock(prompt_mutex);
                             prompt_display_buffer = "Process " + pname + " not found.";
-                        } else if (pcb->hasMemoryViolation) {
+                        } else if (violation) {
                             // Process shut down due to memory violation
                             std::ostringstream oss;
                             oss << "Process " << pname << " shut down due to memory access violation error that occurred at "
-                                << pcb->memoryViolationTime << ". 0x" 
-                                << std::hex << std::uppercase << pcb->memoryViolationAddress << " invalid";
+                                << (pcb ? pcb->memoryViolationTime : retired->memoryViolationTime) << ". 0x" 
+                                << std::hex << std::uppercase
+                                << (pcb ? pcb->memoryViolationAddress : retired->memoryViolationAddress) << " invalid";
                             std::unique_lock<std::mutex> lock(prompt_mutex);
                             prompt_display_buffer = oss.str();
                         } else {
@@ -332,6 +400,7 @@ void command_interpreter_thread_func() {
 
                             bool attached = true;
                             std::string last_input_shown = "";
+                            uint64_t seen_input_version = 0;
                             
                             while (attached && is_running) {
                                 // Display current input being typed
@@ -346,12 +415,17 @@ void command_interpreter_thread_func() {
                                     last_input_shown = current_input_copy;
                                 }
                                 
+                                // Sleep until a command arrives or the typed line changes
                                 std::string subcmd;
                                 {
                                     std::unique_lock<std::mutex> qlock(command_queue_mutex);
+                                    command_cv.wait_for(qlock, std::chrono::seconds(1), [&] {
+                                        return !command_queue.empty() || input_version != seen_input_version || !is_running;
+                                    });
+                                    seen_input_version = input_version;
                                     if (command_queue.empty()) {
                                         qlock.unlock();
-                                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                                        if (command_input_closed()) attached = false; // script ended inside the screen
                                         continue;
                                     }
                                     subcmd = command_queue.front();
@@ -367,18 +441,35 @@ void command_interpreter_thread_func() {
                                 }
                                 std::string scmd = to_lowercase(subtokens[0]);
                                 
-                                if (scmd == "process-smi") {
+                                if (scmd == "process-smi" && pcb) {
                                     std::ostringstream oss;
                                     oss << "Process name: " << pcb->process->name << "\n";
                                     oss << "ID: " << pcb->process->pid << "\n";
                                     oss << "Logs:\n";
-                                    for (auto &l : pcb->logs) oss << l << "\n";
+                                    for (auto &l : pcb->copyLogs()) oss << l << "\n";
                                     oss << "\n";
-                                    oss << "Current instruction line: " << pcb->programCounter << "\n";
-                                    int total_lines = pcb->flattenedInstructions.empty() ? pcb->process->instructions.size() : pcb->flattenedInstructions.size();
+                                    // The live PCB belongs to its core; read the progress it last published
+                                    int current_line = 0;
+                                    int total_lines = 0;
+                                    pcb->readProgress(current_line, total_lines);
+                                    if (total_lines == 0) total_lines = static_cast<int>(pcb->sourceProgram().size());
+                                    oss << "Current instruction line: " << current_line << "\n";
                                     oss << "Lines of code: " << total_lines << "\n";
                                     if (pcb->processState == State::TERMINATED) oss << "\nFinished!\n";
                                     
+                                    std::cout << "\n" << oss.str() << "\n> " << std::flush;
+                                } else if (scmd == "process-smi") {
+                                    // Finished process: logs are read back from the archive on demand
+                                    std::ostringstream oss;
+                                    oss << "Process name: " << retired->name << "\n";
+                                    oss << "ID: " << retired->pid << "\n";
+                                    oss << "Logs:\n";
+                                    for (auto &l : process_archive.readLogs(*retired)) oss << l << "\n";
+                                    oss << "\n";
+                                    oss << "Current instruction line: " << retired->instructionsExecuted << "\n";
+                                    oss << "Lines of code: " << retired->totalInstructions << "\n";
+                                    if (retired->completed) oss << "\nFinished!\n";
+                                    
                                     std::cout << "\n" << oss.str() << "\n> " << std::flush;
                                 } else if (scmd == "exit") {
                                     attached = false;
@@ -420,40 +511,9 @@ void command_interpreter_thread_func() {
             }
             // Report utility
             else if (command == "report-util") {
-                std::ofstream ofs("csopesy-log.txt");
-                if (!ofs) {
-                    std::unique_lock<std::mutex> lock(prompt_mutex);
-                    prompt_display_buffer = "Failed to write report file.";
-                } else {
-                    std::unique_lock<std::mutex> lock(process_table_mutex);
-                    int cores_used = active_cores.load();
-                    int cores_available = num_cpu - cores_used;
-                    
-                    ofs << "CPU utilization: " << (cores_used * 100 / std::max(1, num_cpu)) << "%\n";
-                    ofs << "Cores used: " << cores_used << "\n";
-                    ofs << "Cores available: " << cores_available << "\n\n";
-                    ofs << "Running processes:\n";
-                    
-                    for (auto &kv : process_table) {
-                        auto &pcb = kv.second;
-                        ofs << pcb->process->name << "    ";
-                        ofs << get_timestamp() << "    ";
-                        ofs << "Core: " << (pcb->process->pid % num_cpu) << "    ";
-                        ofs << pcb->programCounter << " / " << pcb->flattenedInstructions.size() << "\n";
-                    }
-                    
-                    ofs << "\nFinished processes:\n";
-                    for (auto &f : finished_processes) {
-                        ofs << f->process->name << "    ";
-                        ofs << get_timestamp() << "    ";
-                        ofs << "Finished    ";
-                        ofs << f->flattenedInstructions.size() << " / " << f->flattenedInstructions.size() << "\n";
-                    }
-                    ofs.close();
-                    
-                    std::unique_lock<std::mutex> lock2(prompt_mutex);
-                    prompt_display_buffer = "Report generated at csopesy-log.txt";
-                }
+                // report-util [-i]: -i appends only processes finished since the last report
+                bool incremental = tokens.size() > 1 && (tokens[1] == "-i" || tokens[1] == "--incremental");
+                request_report(incremental);
             }
             // Memory debugging commands
             else if (command == "process-smi") {
@@ -461,14 +521,15 @@ void command_interpreter_thread_func() {
                     std::unique_lock<std::mutex> lock(prompt_mutex);
                     prompt_display_buffer = "Memory manager not initialized. Run 'initialize' first.";
                 } else {
-                    MemoryStats stats = globalMemory->getStats();
-                    auto processMemInfo = globalMemory->getAllProcessMemoryInfo();
+                    auto snap = latest_snapshot();
+                    const MemoryStats &stats = snap->memory;
+                    const auto &processMemInfo = snap->processMemory;
                     
                     std::ostringstream oss;
                     oss << "=============================================\n";
-                    oss << " PROCESS-SMI " << get_timestamp() << "\n";
+                    oss << " PROCESS-SMI " << snap->timestamp << "\n";
                     oss << "=============================================\n";
-                    oss << "CPU-Util: " << (active_cores.load() * 100 / std::max(1, num_cpu)) << "%\n";
+                    oss << "CPU-Util: " << (snap->coresUsed * 100 / std::max(1, snap->numCpu)) << "%\n";
                     
                     // Convert bytes to MiB (1 MiB = 1024*1024 bytes)
                     size_t usedMiB = stats.usedMemory / (1024 * 1024);
@@ -483,31 +544,15 @@ void command_interpreter_thread_func() {
                     if (processMemInfo.empty()) {
                         oss << "No processes currently allocated in memory.\n";
                     } else {
-                        // Look up process names from process table AND finished processes
-                        std::unique_lock<std::mutex> lock(process_table_mutex);
+                        // Process names come from the registry (covers live AND finished)
                         for (const auto& info : processMemInfo) {
                             int pid = info.first;
                             size_t memBytes = info.second;
                             size_t memMiB = memBytes / (1024 * 1024);
                             if (memMiB == 0 && memBytes > 0) memMiB = 1; // Show at least 1 MiB if not zero
                             
-                            // Find process name by PID (check both active and finished)
-                            std::string processName = "process" + std::to_string(pid);
-                            for (const auto& kv : process_table) {
-                                if (kv.second->process->pid == pid) {
-                                    processName = kv.first;
-                                    break;
-                                }
-                            }
-                            // Also check finished processes
-                            if (processName == "process" + std::to_string(pid)) {
-                                for (const auto& pcb : finished_processes) {
-                                    if (pcb->process->pid == pid) {
-                                        processName = pcb->process->name;
-                                        break;
-                                    }
-                                }
-                            }
+                            std::string processName = process_registry.nameOf(pid);
+                            if (processName.empty()) processName = "process" + std::to_string(pid);
                             
                             oss << std::setw(15) << std::left << processName 
                                 << std::setw(10) << std::right << memMiB << "MiB\n";
@@ -524,45 +569,137 @@ void command_interpreter_thread_func() {
                     std::unique_lock<std::mutex> lock(prompt_mutex);
                     prompt_display_buffer = "Memory manager not initialized. Run 'initialize' first.";
                 } else {
-                    MemoryStats stats = globalMemory->getStats();
+                    auto snap = latest_snapshot();
+                    const MemoryStats &stats = snap->memory;
                     
                     // Show values in BYTES (no unit conversion)
                     std::ostringstream oss;
                     oss << "=============================================\n";
-                    oss << " VMSTAT " << get_timestamp() << "\n";
+                    oss << " VMSTAT " << snap->timestamp << "\n";
                     oss << "=============================================\n";
                     oss << "Total memory: " << stats.totalMemory << " bytes\n";
                     oss << "Used memory:  " << stats.usedMemory << " bytes\n";
                     oss << "Free memory:  " << stats.freeMemory << " bytes\n";
+                    oss << "Committed memory: " << stats.committedMemory << " bytes";
+                    if (stats.commitLimit > 0) oss << " of " << stats.commitLimit;
+                    oss << "\n";
+                    oss << "Pending admission: " << snap->pendingAdmissions << "\n";
                     oss << "Idle cpu ticks: " << stats.idleCpuTicks << "\n";
                     oss << "Active cpu ticks: " << stats.activeCpuTicks << "\n";
                     oss << "Total cpu ticks: " << (stats.idleCpuTicks + stats.activeCpuTicks) << "\n";
                     oss << "Num paged in: " << stats.numPagedIn << "\n";
                     oss << "Num paged out: " << stats.numPagedOut << "\n";
+                    oss << "Display output: " << display_bytes_per_sec.load() << " bytes/sec\n";
+                    oss << "=============================================\n";
+                    oss << format_process_timing(scheduler_policy_name(scheduler_policy));
+                    oss << format_core_affinity(snap->numCpu);
+                    oss << format_quantum_tuning();
+                    oss << format_replay_status();
+                    oss << format_program_cache();
+                    oss << format_preparation();
+                    oss << format_admission_rejects();
+                    if (scheduler_policy == SchedulerPolicy::CFS) {
+                        oss << "Fairness (Jain index, " << snap->running.size() << " live): " << std::fixed
+                            << std::setprecision(3) << snap->fairnessIndex << "\n";
+                    }
                     oss << "=============================================\n";
                     
                     std::unique_lock<std::mutex> lock(prompt_mutex);
                     prompt_display_buffer = oss.str();
                 }
             }
+            else if (command == "trace-start") {
+                trace_start();
+                std::unique_lock<std::mutex> lock(prompt_mutex);
+                prompt_display_buffer = "Tracing started.";
+            }
+            else if (command == "trace-stop") {
+                trace_stop();
+                std::unique_lock<std::mutex> lock(prompt_mutex);
+                prompt_display_buffer = "Tracing stopped.";
+            }
+            else if (command == "trace-dump") {
+                // trace-dump <file>: Chrome trace JSON, open in chrome://tracing or ui.perfetto.dev
+                std::string path = tokens.size() > 1 ? tokens[1] : "csopesy-trace.json";
+                size_t written = 0;
+                bool ok = trace_dump(path, written);
+                std::unique_lock<std::mutex> lock(prompt_mutex);
+                if (ok) {
+                    prompt_display_buffer = "Wrote " + std::to_string(written) + " trace events to " + path;
+                } else {
+                    prompt_display_buffer = "Failed to write " + path;
+                }
+            }
+            else if (command == "replay") {
+                // replay <file> | replay stop
+                std::string message;
+                if (tokens.size() == 2 && tokens[1] == "stop") {
+                    replay_stop();
+                    message = "Replay stopped.";
+                } else if (tokens.size() == 2) {
+                    if (!is_scheduler_active()) scheduler_start();
+                    if (replay_start(tokens[1], message)) message = "Replaying " + tokens[1] + ".";
+                } else {
+                    message = format_replay_status();
+                    if (message.empty()) message = "Usage: replay <file> | replay stop";
+                }
+                std::unique_lock<std::mutex> lock(prompt_mutex);
+                prompt_display_buffer = message;
+            }
+            else if (command == "capture") {
+                // capture <file> | capture stop
+                std::string message;
+                if (tokens.size() == 2 && tokens[1] == "stop") {
+                    message = "Captured " + std::to_string(capture_stop()) + " processes.";
+                } else if (tokens.size() == 2) {
+                    if (capture_start(tokens[1], message)) message = "Capturing new processes to " + tokens[1] + ".";
+                } else {
+                    message = "Usage: capture <file> | capture stop";
+                }
+                std::unique_lock<std::mutex> lock(prompt_mutex);
+                prompt_display_buffer = message;
+            }
+            else if (command == "cores") {
+                // cores | cores add <n> | cores remove <n>
+                int n = 0;
+                std::string message;
+                if (tokens.size() == 1) {
+                    message = format_core_phases();
+                } else if (tokens.size() == 3 && (tokens[1] == "add" || tokens[1] == "remove") &&
+                           parse_integer(tokens[2], n) && n > 0) {
+                    int target = online_core_count() + (tokens[1] == "add" ? n : -n);
+                    scheduler_set_cores(target, message);
+                } else {
+                    message = "Usage: cores [add <n> | remove <n>]";
+                }
+                std::unique_lock<std::mutex> lock(prompt_mutex);
+                prompt_display_buffer = message;
+            }
             else if (command == "help") {
                 std::unique_lock<std::mutex> lock(prompt_mutex);
                 prompt_display_buffer =
                     "Available commands:\n"
                     "initialize - read config.txt\n"
-                    "screen -s <name> <mem_size> - create process (mem_size: 64-65536, power of 2)\n"
-                    "screen -c <name> <mem_size> \"<instructions>\" - create process with custom instructions\n"
+                    "screen -s <name> <mem_size> [-p <prio>] [-n <nice>] - create process (mem_size: 64-65536, power of 2)\n"
+                    "screen -c <name> <mem_size> [-p <prio>] [-n <nice>] [-rt <period> <deadline> [-jobs <n>]] \"<instructions>\" - create process with custom instructions\n"
+                    "screen -f <name> <mem_size> [-p <prio>] [-n <nice>] <file> - create process running a program file\n"
                     "screen -ls - list processes\n"
                     "screen -r <name> - attach to process\n"
                     "scheduler-start - start scheduler\n"
                     "scheduler-stop - stop scheduler\n"
-                    "report-util - generate report\n"
+                    "report-util [-i] - generate report (-i: append newly finished only)\n"
                     "process-smi - show memory and process info\n"
                     "vmstat - show virtual memory statistics\n"
+                    "cores [add <n> | remove <n>] - show or change the running core count\n"
+                    "trace-start / trace-stop - record scheduler events\n"
+                    "trace-dump <file> - export recorded events as Chrome trace JSON\n"
+                    "capture <file> | capture stop - record submitted processes as a workload trace\n"
+                    "replay <file> | replay stop - submit the processes of a workload trace at their recorded ticks\n"
                     "start_marquee - start animation\n"
                     "stop_marquee - stop animation\n"
                     "set_text <text> - set marquee text\n"
                     "set_speed <ms> - set animation speed\n"
+                    "wait <seconds> - pause command processing (scripts)\n"
                     "exit - quit program";
             } else if (command == "start_marquee") {
                 marquee_running = true;
@@ -610,15 +747,44 @@ void command_interpreter_thread_func() {
                     std::unique_lock<std::mutex> lock(prompt_mutex);
                     prompt_display_buffer = "No speed parameter provided.";
                 }
+            } else if (command == "wait") {
+                // wait <seconds>: pause command processing (for scripts and automation)
+                int seconds = 0;
+                if (tokens.size() > 1 && parse_integer(tokens[1], seconds) && seconds >= 0) {
+                    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+                    std::unique_lock<std::mutex> lock(prompt_mutex);
+                    prompt_display_buffer = "Waited " + std::to_string(seconds) + " s.";
+                } else {
+                    std::unique_lock<std::mutex> lock(prompt_mutex);
+                    prompt_display_buffer = "Usage: wait <seconds>";
+                }
             } else if (command == "exit") {
-                is_running = false;
-                std::unique_lock<std::mutex> lock(prompt_mutex);
-                prompt_display_buffer = "Exiting console.";
+                {
+                    std::unique_lock<std::mutex> lock(prompt_mutex);
+                    prompt_display_buffer = "Exiting console.";
+                }
+                request_shutdown();
             } else {
                 std::unique_lock<std::mutex> lock(prompt_mutex);
                 prompt_display_buffer = "Unknown command. Type 'help' for commands.";
             }
+            notify_display(); // the prompt (or screen state) may have changed
+            if (headless_mode) {
+                // No TUI: every command's feedback goes straight to stdout
+                std::unique_lock<std::mutex> lock(prompt_mutex);
+                if (!prompt_display_buffer.empty()) std::cout << prompt_display_buffer << std::endl;
+            }
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+}
+
+void run_command_script(std::istream& in) {
+    std::string line;
+    while (is_running && std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue; // blank lines and comments
+        enqueue_command(line);
+    }
+    // End of script: the interpreter stops once everything queued has run
+    close_command_input();
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 // interpreter.h
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
+#include <istream>
 void command_interpreter_thread_func();
+// Headless mode: queues every line of `in` as a command, then closes command input
+void run_command_script(std::istream& in);
 #endif
\ No newline at end of file
@@ -2,75 +2,114 @@
 #include "keyboard.h"
 #include "globals.h"
 #include "utils.h"
+#include "display.h"
 #include <thread>
 #include <chrono>
 #include <cctype>
 
 #ifdef _WIN32
 #include <conio.h>
+#include <windows.h>
 #else
 #include <unistd.h>
+#include <poll.h>
+#include <cerrno>
 #endif
 
+#ifndef _WIN32
+// Self-pipe used to wake the blocking poll() on shutdown
+static int wake_pipe[2] = {-1, -1};
+#endif
+
+void wake_keyboard_thread() {
+#ifndef _WIN32
+    // write() is async-signal-safe, so this may be called from the SIGINT handler
+    if (wake_pipe[1] >= 0) {
+        char b = 1;
+        ssize_t ignored = write(wake_pipe[1], &b, 1);
+        (void)ignored;
+    }
+#endif
+}
+
+// Applies one keypress to the input line; returns false on Ctrl-C
+static bool handle_key(int ch) {
+    std::unique_lock<std::mutex> lock(input_mutex);
+    if (ch == '\n' || ch == '\r') { // Enter
+        std::string line = current_input;
+        current_input.clear();
+        lock.unlock();
+        // Clear prompt display buffer when new command is entered
+        {
+            std::unique_lock<std::mutex> plock(prompt_mutex);
+            prompt_display_buffer = "";
+        }
+        enqueue_command(line);
+    } else if (ch == 8 || ch == 127) { // Backspace
+        if (!current_input.empty()) current_input.pop_back();
+    } else if (ch == 3) { // Ctrl-C
+        return false;
+    } else if (isprint(static_cast<unsigned char>(ch))) {
+        current_input.push_back((char)ch);
+    }
+    if (lock.owns_lock()) lock.unlock();
+    notify_input_changed();
+    notify_display();
+    return true;
+}
+
 void keyboard_handler_thread_func() {
 #ifdef _WIN32
+    HANDLE hIn = GetStdHandle(STD_INPUT_HANDLE);
     while (is_running) {
-        if (_kbhit()) {
-            int ch = _getch();
-            std::unique_lock<std::mutex> lock(input_mutex);
-            if (ch == 13) { // Enter
-                std::string line = current_input;
-                current_input.clear();
-                lock.unlock();
-                // Clear prompt display buffer when new command is entered
-                {
-                    std::unique_lock<std::mutex> plock(prompt_mutex);
-                    prompt_display_buffer = "";
-                }
-                std::unique_lock<std::mutex> qlock(command_queue_mutex);
-                command_queue.push(line);
-            } else if (ch == 8 || ch == 127) { // Backspace
-                if (!current_input.empty()) current_input.pop_back();
-            } else if (ch == 3) { // Ctrl-C
-                is_running = false;
-            } else if (isprint(static_cast<unsigned char>(ch))) {
-                current_input.push_back((char)ch);
-            }
-        } else {
+        // Sleep in the kernel until the console has input (or re-check shutdown)
+        if (hIn != INVALID_HANDLE_VALUE) WaitForSingleObject(hIn, 500);
+        if (!_kbhit()) {
+            // Non-key console events (focus, mouse) also signal the handle
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        while (_kbhit()) {
+            if (!handle_key(_getch())) {
+                request_shutdown();
+                break;
+            }
         }
     }
 #else
     enable_raw_mode();
+    if (pipe(wake_pipe) != 0) wake_pipe[0] = wake_pipe[1] = -1;
     while (is_running) {
-        char c = 0;
-        ssize_t n = read(STDIN_FILENO, &c, 1);
-        if (n > 0) {
-            std::unique_lock<std::mutex> lock(input_mutex);
-            if (c == '\n' || c == '\r') {
-                std::string line = current_input;
-                current_input.clear();
-                lock.unlock();
-                // Clear prompt display buffer when new command is entered
-                {
-                    std::unique_lock<std::mutex> plock(prompt_mutex);
-                    prompt_display_buffer = "";
-                }
-                std::unique_lock<std::mutex> qlock(command_queue_mutex);
-                command_queue.push(line);
-            } else if (c == 127 || c == 8) { // Backspace
-                if (!current_input.empty()) current_input.pop_back();
-            } else if (c == 3) { // Ctrl-C
-                is_running = false;
-                break;
-            } else if (isprint((unsigned char)c)) {
-                current_input.push_back(c);
-            }
-        } else {
-            // No input
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        struct pollfd fds[2];
+        fds[0].fd = STDIN_FILENO;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = wake_pipe[0];
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+        int nfds = (wake_pipe[0] >= 0) ? 2 : 1;
+        // Block until input arrives; without a wake pipe fall back to re-checking shutdown
+        int ready = poll(fds, nfds, (wake_pipe[0] >= 0) ? -1 : 500);
+        if (ready <= 0) continue; // timeout or EINTR: loop re-checks is_running
+        if (!(fds[0].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+        char buf[256];
+        ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+        if (n == 0) { // EOF: nothing more will arrive
+            close_command_input();
+            break;
+        }
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) continue;
+            break;
+        }
+        bool keep_running = true;
+        for (ssize_t i = 0; i < n && keep_running; ++i) keep_running = handle_key(buf[i]);
+        if (!keep_running) {
+            request_shutdown();
+            break;
         }
     }
     disable_raw_mode();
 #endif
-}
\ No newline at end of file
+}
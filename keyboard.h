@@ -2,4 +2,6 @@
 #ifndef KEYBOARD_H
 #define KEYBOARD_H
 void keyboard_handler_thread_func();
+// Interrupts the blocking wait for input (safe to call from a signal handler)
+void wake_keyboard_thread();
 #endif
\ No newline at end of file
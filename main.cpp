@@ -4,12 +4,69 @@
 #include "interpreter.h"
 #include "marquee.h"
 #include "display.h"
+#include "report.h"
+#include "benchmark.h"
 #include <thread>
 #include <csignal>
+#include <fstream>
+#include <iostream>
+#include <string>
 
-int main() {
+// Forward declaration from scheduler.cpp
+void scheduler_stop();
+
+static void print_usage() {
+    std::cout << "Usage: csopesy [--headless | --script <file> | --bench <config> [--duration <seconds>]]\n"
+              << "  --headless        read commands from stdin, no console UI\n"
+              << "  --script <file>   run the commands in <file>, no console UI\n"
+              << "  --bench <config>  run scheduler-test with <config> and print JSON results\n"
+              << "  --duration <s>    benchmark length in seconds (default 10)\n";
+}
+
+int main(int argc, char* argv[]) {
     std::signal(SIGINT, handle_sigint); // ensure cleanup on Ctrl-C
 
+    std::string script_path;
+    std::string bench_config;
+    int bench_seconds = 10;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench" && i + 1 < argc) {
+            bench_config = argv[++i];
+        } else if (arg == "--duration" && i + 1 < argc && parse_integer(argv[i + 1], bench_seconds) && bench_seconds > 0) {
+            ++i;
+        } else if (arg == "--headless") {
+            headless_mode = true;
+        } else if (arg == "--script" && i + 1 < argc) {
+            headless_mode = true;
+            script_path = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (!bench_config.empty()) {
+        return run_benchmark(bench_config, bench_seconds, std::cout);
+    }
+
+    if (headless_mode) {
+        // Commands are fed from a file or pipe; output is plain text on stdout
+        std::thread command_interpreter_thread(command_interpreter_thread_func);
+        if (script_path.empty()) {
+            run_command_script(std::cin);
+        } else {
+            std::ifstream script(script_path);
+            if (!script) std::cerr << "Cannot open script " << script_path << "\n";
+            run_command_script(script);
+        }
+        command_interpreter_thread.join();
+        request_shutdown();
+        scheduler_stop();
+        shutdown_report_writer();
+        return 0;
+    }
+
 #ifdef _WIN32
     // Enable ANSI escape sequences on Windows
     enable_windows_ansi();
@@ -26,11 +83,16 @@ int main() {
     std::thread keyboard_handler_thread(keyboard_handler_thread_func);
     std::thread command_interpreter_thread(command_interpreter_thread_func);
 
-    // Join all threads
+    // The interpreter returns on 'exit', Ctrl-C or end of input; then stop everything else
+    command_interpreter_thread.join();
+    request_shutdown();
     marquee_logic_thread.join();
     display_thread.join();
     keyboard_handler_thread.join();
-    command_interpreter_thread.join();
+
+    // Join scheduler threads and let any queued report finish writing
+    scheduler_stop();
+    shutdown_report_writer();
 
 #ifndef _WIN32
     // restore terminal if still in raw mode
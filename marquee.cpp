@@ -1,6 +1,7 @@
 // marquee.cpp
 #include "marquee.h"
 #include "globals.h"
+#include "display.h"
 #include <thread>
 #include <chrono>
 
@@ -15,6 +16,7 @@ void marquee_logic_thread_func(int display_width) {
             }
             int cycle = std::max(text_len, display_width) + display_width;
             marquee_position = (marquee_position + 1) % cycle;
+            notify_display();
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(marquee_speed));
     }
@@ -1,5 +1,6 @@
 #include "memory.h"
 #include "globals.h"
+#include "trace.h"
 
 #include <fstream>
 #include <iostream>
@@ -99,6 +100,12 @@ void initializeMemory(size_t totalMemory) {
 bool Memory::allocateProcess(int processId, size_t processMemorySize) {
     std::lock_guard<std::mutex> lock(memoryMutex);
     size_t pagesNeeded = (processMemorySize + getPageSize() - 1) / getPageSize();
+    size_t previous = 0;
+    auto existing = pageTables.find(processId);
+    if (existing != pageTables.end()) previous = existing->second.size() * getPageSize();
+    size_t committed = committedBytes - previous + pagesNeeded * getPageSize();
+    if (commitLimit > 0 && committed > commitLimit) return false;
+    committedBytes = committed;
     pageTables[processId] = std::vector<PageTableEntry>(pagesNeeded);
     for (size_t i = 0; i < pagesNeeded; ++i) {
         pageTables[processId][i].pageNumber = i;
@@ -113,6 +120,7 @@ void Memory::deallocateProcess(int processId) {
     std::lock_guard<std::mutex> lock(memoryMutex);
     auto it = pageTables.find(processId);
     if (it == pageTables.end()) return; // process not found
+    committedBytes -= std::min(committedBytes, it->second.size() * getPageSize());
     // frees the frames usedby the process
     for (auto &pte : it->second) {
         if (pte.isValid && pte.frameNumber >= 0 && static_cast<size_t>(pte.frameNumber) < frames.size()) {
@@ -215,6 +223,7 @@ bool Memory::accessMemory(int processId, size_t virtualAddress, bool isWrite) {
     if (pageNumber >= it->second.size()) return false;
     PageTableEntry &pageEntry = it->second[pageNumber];
     if (!pageEntry.isValid) { // for page faults (aka page not in memory)
+        trace_event(TraceEventType::PageFault, processId, virtualAddress);
         int frameIndex = -1;
         if (!freeFrameList.empty()) {
             frameIndex = freeFrameList.front();
@@ -270,6 +279,8 @@ bool Memory::writeByte(int processId, size_t virtualAddress, uint8_t value) {
 MemoryStats Memory::getStats() const {
     std::lock_guard<std::mutex> lock(memoryMutex);
     MemoryStats copy = stats;
+    copy.committedMemory = committedBytes;
+    copy.commitLimit = commitLimit;
     // Recompute free memory to avoid drift
     if (copy.totalMemory >= copy.usedMemory) copy.freeMemory = copy.totalMemory - copy.usedMemory; else copy.freeMemory = 0;
     return copy;
@@ -280,6 +291,17 @@ void Memory::updateCpuTicks(bool isIdle) {
     if (isIdle) stats.idleCpuTicks++; else stats.activeCpuTicks++;
 }
 
+void Memory::setCommitLimit(size_t bytes) {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    commitLimit = bytes;
+}
+
+bool Memory::fitsCommitLimit(size_t processMemorySize) const {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    size_t pagesNeeded = (processMemorySize + getPageSize() - 1) / getPageSize();
+    return commitLimit == 0 || pagesNeeded * getPageSize() <= commitLimit;
+}
+
 // returns memory usage in bytes
 size_t Memory::getProcessMemoryUsage(int processId) const {
     std::lock_guard<std::mutex> lock(memoryMutex);
@@ -41,6 +41,8 @@ struct MemoryStats {
     size_t numPagedOut = 0;
     uint64_t idleCpuTicks = 0;
     uint64_t activeCpuTicks = 0;
+    size_t committedMemory = 0; // virtual memory promised to allocated processes
+    size_t commitLimit = 0;     // 0 = unlimited
 };
 
 // Manages virtual memory with paging and LRU page replacement
@@ -50,6 +52,7 @@ public:
     Memory(size_t totalMemory, const std::string& backingStore = "csopesy-backing-store.txt");
     ~Memory();
 
+    // Fails without side effects when the commit limit would be exceeded
     bool allocateProcess(int processId, size_t processMemorySize);
     void deallocateProcess(int processId);
 
@@ -59,6 +62,9 @@ public:
 
     MemoryStats getStats() const;
     void updateCpuTicks(bool isIdle);
+    void setCommitLimit(size_t bytes);
+    // False if a process of this size exceeds the commit limit even with nothing else allocated
+    bool fitsCommitLimit(size_t processMemorySize) const;
 
     size_t getProcessMemoryUsage(int processId) const;
     std::vector<std::pair<int, size_t>> getAllProcessMemoryInfo() const;
@@ -66,6 +72,8 @@ public:
     void printMemoryState() const;
 
 private:
+    friend struct MemoryBenchmarkAccess; // bench/microbench.cpp times the eviction scan directly
+
     int findOldestFrameLRU();
     void removePage(int frameIndex);
     void loadPage(int processId, size_t pageNumber, int frameIndex);
@@ -80,6 +88,8 @@ private:
     std::string backingStoreFile;
     uint64_t currentTime;
     MemoryStats stats;
+    size_t committedBytes = 0;
+    size_t commitLimit = 0;
     mutable std::mutex memoryMutex;
     // Tracks which (pid,page) pairs have been written to backing store at least once
     std::unordered_set<uint64_t> backingStorePresence;
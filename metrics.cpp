@@ -0,0 +1,171 @@
+#include "metrics.h"
+
+#include "process.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+
+std::atomic<uint64_t> instructions_executed{0};
+std::atomic<uint64_t> dispatch_count{0};
+std::atomic<uint64_t> context_switches{0};
+std::atomic<uint64_t> migrations{0};
+std::atomic<uint64_t> core_dispatches[MAX_SCHEDULER_CORES];
+std::atomic<uint64_t> core_migrations[MAX_SCHEDULER_CORES];
+LatencyHistogram scheduling_latency;
+LatencyHistogram preparation_latency;
+
+// Histograms are updated lock-free; the mutex only guards creating map entries
+static std::mutex timing_mutex;
+static std::map<std::string, std::unique_ptr<ProcessTimingStats>> timing_by_scheduler;
+
+int LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < static_cast<uint64_t>(SUB_BUCKETS)) return static_cast<int>(value);
+    int msb = 63;
+    while (!(value >> msb)) --msb;
+    int shift = msb - SUB_BUCKET_BITS;
+    int sub = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketValue(int index) {
+    if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+    int shift = index / SUB_BUCKETS - 1;
+    uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+    uint64_t low = (static_cast<uint64_t>(SUB_BUCKETS) | sub) << shift;
+    return low + ((uint64_t{1} << shift) >> 1);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t prev = maxValue.load(std::memory_order_relaxed);
+    while (value > prev && !maxValue.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(n));
+    if (rank >= n) rank = n - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen > rank) return std::min(bucketValue(i), max());
+    }
+    return max();
+}
+
+uint64_t LatencyHistogram::count() const {
+    return total.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    total = 0;
+    sum = 0;
+    maxValue = 0;
+}
+
+ProcessTimingStats& process_timing(const std::string& scheduler) {
+    std::lock_guard<std::mutex> lock(timing_mutex);
+    auto& stats = timing_by_scheduler[scheduler];
+    if (!stats) stats = std::make_unique<ProcessTimingStats>();
+    return *stats;
+}
+
+void record_process_timing(const std::string& scheduler, const ProcessControlBlock& pcb) {
+    if (!pcb.arrived) return;
+    ProcessTimingStats& stats = process_timing(scheduler);
+    if (pcb.hasRun) stats.response.record(pcb.firstRunTick - std::min(pcb.firstRunTick, pcb.arrivalTick));
+    stats.waiting.record(pcb.waitingTicks);
+    stats.turnaround.record(pcb.finishTick - std::min(pcb.finishTick, pcb.arrivalTick));
+}
+
+void record_deadline(ProcessTimingStats& stats, uint64_t lateness) {
+    stats.lateness.record(lateness);
+    if (lateness > 0) stats.deadlineMisses++;
+}
+
+static void append_histogram_row(std::string& out, const char* label, const LatencyHistogram& h) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "  %-11s mean %9.1f  p50 %8llu  p90 %8llu  p99 %8llu  max %8llu\n", label, h.mean(),
+                  static_cast<unsigned long long>(h.percentile(50)), static_cast<unsigned long long>(h.percentile(90)),
+                  static_cast<unsigned long long>(h.percentile(99)), static_cast<unsigned long long>(h.max()));
+    out += line;
+}
+
+std::string format_process_timing(const std::string& scheduler) {
+    std::string out;
+    std::lock_guard<std::mutex> lock(timing_mutex);
+    for (const auto& entry : timing_by_scheduler) {
+        if (!scheduler.empty() && entry.first != scheduler) continue;
+        const ProcessTimingStats& stats = *entry.second;
+        out += "Scheduling times (cpu ticks), " + entry.first + ", " + std::to_string(stats.turnaround.count()) +
+               " finished:\n";
+        append_histogram_row(out, "response", stats.response);
+        append_histogram_row(out, "waiting", stats.waiting);
+        append_histogram_row(out, "turnaround", stats.turnaround);
+        append_histogram_row(out, "run burst", stats.burst);
+        if (stats.lateness.count() > 0) {
+            append_histogram_row(out, "lateness", stats.lateness);
+            out += "  deadlines missed: " + std::to_string(stats.deadlineMisses.load()) + " of " +
+                   std::to_string(stats.lateness.count()) + " real-time jobs\n";
+        }
+    }
+    if (out.empty()) out = "Scheduling times (cpu ticks): no finished processes yet\n";
+    return out;
+}
+
+std::string format_core_affinity(int numCores) {
+    std::string out = "Migrations: " + std::to_string(migrations.load()) + " of " + std::to_string(dispatch_count.load()) +
+                      " dispatches\n";
+    for (int c = 0; c < std::min(numCores, MAX_SCHEDULER_CORES); ++c) {
+        uint64_t dispatched = core_dispatches[c].load(std::memory_order_relaxed);
+        if (dispatched == 0) continue;
+        out += "  core " + std::to_string(c) + ": " + std::to_string(dispatched) + " dispatches, " +
+               std::to_string(core_migrations[c].load(std::memory_order_relaxed)) + " migrations in\n";
+    }
+    return out;
+}
+
+double jain_fairness_index(const std::vector<double>& values) {
+    double sum = 0.0;
+    double squares = 0.0;
+    for (double v : values) {
+        sum += v;
+        squares += v * v;
+    }
+    if (values.empty() || squares <= 0.0) return 1.0;
+    return (sum * sum) / (static_cast<double>(values.size()) * squares);
+}
+
+void reset_scheduler_metrics() {
+    instructions_executed = 0;
+    dispatch_count = 0;
+    context_switches = 0;
+    migrations = 0;
+    for (int c = 0; c < MAX_SCHEDULER_CORES; ++c) {
+        core_dispatches[c] = 0;
+        core_migrations[c] = 0;
+    }
+    scheduling_latency.reset();
+    preparation_latency.reset();
+    std::lock_guard<std::mutex> lock(timing_mutex);
+    for (auto& entry : timing_by_scheduler) {
+        entry.second->response.reset();
+        entry.second->waiting.reset();
+        entry.second->turnaround.reset();
+        entry.second->burst.reset();
+        entry.second->lateness.reset();
+        entry.second->deadlineMisses = 0;
+    }
+}
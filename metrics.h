@@ -0,0 +1,78 @@
+#ifndef CSOPESY_METRICS_H
+#define CSOPESY_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ready_queue.h"
+
+struct ProcessControlBlock;
+
+// Log-linear (HDR-style) histogram: 16 sub-buckets per power of two, so any
+// recorded value is reported within ~6% of its true value. Lock-free: every
+// record() is a single relaxed atomic increment.
+class LatencyHistogram {
+public:
+    void record(uint64_t value);
+    uint64_t percentile(double p) const;   // p in [0, 100]
+    uint64_t count() const;
+    uint64_t max() const { return maxValue.load(std::memory_order_relaxed); }
+    double mean() const;
+    void reset();
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketValue(int index);    // representative (midpoint) value
+
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> maxValue{0};
+};
+
+// Scheduler throughput counters
+extern std::atomic<uint64_t> instructions_executed;
+extern std::atomic<uint64_t> dispatch_count;         // processes handed to a core
+extern std::atomic<uint64_t> context_switches;       // dispatches of a different process than the core last ran
+extern LatencyHistogram scheduling_latency;          // ready -> dispatched, nanoseconds
+extern LatencyHistogram preparation_latency;         // submitted -> program prepared for admission, nanoseconds
+extern std::atomic<uint64_t> migrations;             // dispatches on a different core than the process last ran on
+
+// Per-core dispatch and migration counts
+extern std::atomic<uint64_t> core_dispatches[MAX_SCHEDULER_CORES];
+extern std::atomic<uint64_t> core_migrations[MAX_SCHEDULER_CORES];  // counted on the core the process moved to
+// One line per core that has dispatched anything
+std::string format_core_affinity(int numCores);
+
+// Per-process scheduling times aggregated per scheduler, in CPU ticks
+struct ProcessTimingStats {
+    LatencyHistogram response;    // arrival -> first dispatch
+    LatencyHistogram waiting;     // total time in the ready queue
+    LatencyHistogram turnaround;  // arrival -> finish
+    LatencyHistogram burst;       // time on a core per dispatch
+    LatencyHistogram lateness;    // EDF: finish past the deadline per real-time job (0 = on time)
+    std::atomic<uint64_t> deadlineMisses{0};
+};
+
+// Stats for one scheduler type ("rr", "fcfs", ...); created on first use, never freed
+ProcessTimingStats& process_timing(const std::string& scheduler);
+// Records a finished process's response, waiting and turnaround times
+void record_process_timing(const std::string& scheduler, const ProcessControlBlock& pcb);
+// Records one completed real-time job's lateness in ticks
+void record_deadline(ProcessTimingStats& stats, uint64_t lateness);
+// Summary table; only `scheduler` if given, otherwise every scheduler with data
+std::string format_process_timing(const std::string& scheduler = "");
+
+// Jain's fairness index of the given allocations: 1.0 when all are equal, 1/n when one
+// process gets everything. Returns 1.0 for an empty set.
+double jain_fairness_index(const std::vector<double>& values);
+
+void reset_scheduler_metrics();
+
+#endif // CSOPESY_METRICS_H
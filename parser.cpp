@@ -0,0 +1,256 @@
+#include "parser.h"
+#include "process.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::string ParseError::describe() const {
+    if (line == 0) return message;
+    return "line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + message;
+}
+
+// ASCII-only classification: the <cctype> calls go through the locale for every character
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static bool is_hex_digit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool equals_ignore_case(std::string_view word, const char* name) {
+    size_t i = 0;
+    for (; i < word.size() && name[i]; ++i) {
+        char c = word[i];
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+        if (c != name[i]) return false;
+    }
+    return i == word.size() && !name[i];
+}
+
+namespace {
+
+class ProgramParser {
+public:
+    ProgramParser(std::string_view text, ParseError& error) : text(text), error(error) {}
+
+    bool parse(std::vector<Instruction>& out) { return statements(0, out, 0); }
+
+private:
+    std::string_view text;
+    ParseError& error;
+    size_t pos = 0;
+
+    char peek() const { return pos < text.size() ? text[pos] : '\0'; }
+    bool at_end() const { return pos >= text.size(); }
+
+    // Line and column are only worked out here, so the happy path never counts newlines
+    bool fail(size_t at, const std::string& message) {
+        error.line = 1;
+        size_t lineStart = 0;
+        for (size_t i = 0; i < at && i < text.size(); ++i) {
+            if (text[i] == '\n') {
+                error.line++;
+                lineStart = i + 1;
+            }
+        }
+        error.column = at - lineStart + 1;
+        error.message = message;
+        return false;
+    }
+
+    void skip_blanks() {
+        while (!at_end() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r')) pos++;
+    }
+
+    static bool ends_word(char c) {
+        return is_space(c) || c == ';' || c == '{' || c == '}' || c == '#' || c == '(';
+    }
+
+    std::string_view word() {
+        skip_blanks();
+        size_t start = pos;
+        while (!at_end() && !ends_word(text[pos])) pos++;
+        return text.substr(start, pos - start);
+    }
+
+    bool operand(std::string& out, const char* what) {
+        size_t at = (skip_blanks(), pos);
+        std::string_view w = word();
+        if (w.empty()) return fail(at, std::string("expected ") + what);
+        out.assign(w);
+        return true;
+    }
+
+    bool number(uint16_t& out, unsigned max, const char* what) {
+        size_t at = (skip_blanks(), pos);
+        std::string_view w = word();
+        unsigned value = 0;
+        for (char c : w) {
+            if (c < '0' || c > '9') return fail(at, std::string("expected ") + what + ", got '" + std::string(w) + "'");
+            value = value * 10 + static_cast<unsigned>(c - '0');
+            if (value > max) return fail(at, std::string("expected ") + what + " of at most " + std::to_string(max));
+        }
+        if (w.empty()) return fail(at, std::string("expected ") + what);
+        out = static_cast<uint16_t>(value);
+        return true;
+    }
+
+    bool address(std::string& out) {
+        size_t at = (skip_blanks(), pos);
+        std::string_view w = word();
+        std::string_view digits = w;
+        if (digits.size() >= 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) digits.remove_prefix(2);
+        bool ok = !digits.empty();
+        for (char c : digits) ok = ok && is_hex_digit(c);
+        if (!ok) return fail(at, w.empty() ? "expected an address" : "expected a hex address, got '" + std::string(w) + "'");
+        out.assign(w);
+        return true;
+    }
+
+    // PRINT takes the rest of the statement verbatim; ';' and '}' inside quotes do not end it
+    void print_text(std::string& out, int depth) {
+        skip_blanks();
+        size_t start = pos;
+        bool inQuotes = false;
+        for (; !at_end(); ++pos) {
+            char c = text[pos];
+            if (c == '"') inQuotes = !inQuotes;
+            else if (!inQuotes && (c == ';' || c == '\n' || (c == '}' && depth > 0))) break;
+        }
+        size_t end = pos;
+        while (end > start && is_space(text[end - 1])) end--;
+        out.assign(text.substr(start, end - start));
+    }
+
+    bool statement(int depth, std::vector<Instruction>& out) {
+        size_t at = pos;
+        std::string_view name = word();
+        Instruction instr{};
+        bool ok = true;
+        if (equals_ignore_case(name, "PRINT")) {
+            instr.type = PRINT;
+            print_text(instr.arg1, depth);
+        } else if (equals_ignore_case(name, "DECLARE")) {
+            instr.type = DECLARE;
+            ok = operand(instr.arg1, "a variable name") && number(instr.val1, 65535, "a value");
+        } else if (equals_ignore_case(name, "ADD") || equals_ignore_case(name, "SUBTRACT")) {
+            instr.type = equals_ignore_case(name, "ADD") ? ADD : SUBTRACT;
+            ok = operand(instr.arg1, "a variable name") && operand(instr.arg2, "an operand") &&
+                 operand(instr.arg3, "an operand");
+        } else if (equals_ignore_case(name, "READ")) {
+            instr.type = READ_MEM;
+            ok = operand(instr.arg1, "a variable name") && address(instr.arg2);
+        } else if (equals_ignore_case(name, "WRITE")) {
+            instr.type = WRITE_MEM;
+            ok = address(instr.arg1) && operand(instr.arg2, "a variable name");
+        } else if (equals_ignore_case(name, "SLEEP")) {
+            instr.type = SLEEP;
+            ok = number(instr.val1, 255, "a tick count");
+        } else if (equals_ignore_case(name, "FOR")) {
+            instr.type = FOR_LOOP;
+            if (!number(instr.val1, 65535, "a repeat count")) return false;
+            skip_blanks();
+            if (peek() != '{') return fail(pos, "expected '{' after the FOR repeat count");
+            if (depth + 1 > MAX_FOR_NESTING) {
+                return fail(at, "FOR loops nest at most " + std::to_string(MAX_FOR_NESTING) + " deep");
+            }
+            size_t open = pos++;
+            if (!statements(depth + 1, instr.instrSet, open)) return false;
+        } else {
+            return fail(at, name.empty() ? "expected an instruction" : "unknown instruction '" + std::string(name) + "'");
+        }
+        if (!ok) return false;
+        out.push_back(std::move(instr));
+        return true;
+    }
+
+    // Statements up to the end of the text (depth 0) or the '}' matching the '{' at `open`
+    bool statements(int depth, std::vector<Instruction>& out, size_t open) {
+        while (true) {
+            while (!at_end() && (is_space(text[pos]) || text[pos] == ';')) pos++;
+            if (peek() == '#') {
+                while (!at_end() && text[pos] != '\n') pos++;
+                continue;
+            }
+            if (at_end()) return depth == 0 || fail(open, "'{' is never closed");
+            if (peek() == '}') {
+                if (depth == 0) return fail(pos, "unexpected '}'");
+                pos++;
+                return true;
+            }
+            if (!statement(depth, out)) return false;
+            skip_blanks();
+            char c = peek();
+            if (!(at_end() || c == ';' || c == '\n' || c == '}' || c == '#')) {
+                size_t at = pos;
+                return fail(at, "unexpected '" + std::string(word()) + "' after the instruction");
+            }
+        }
+    }
+};
+
+} // namespace
+
+bool parse_program(std::string_view text, std::vector<Instruction>& out, ParseError& error) {
+    // Every statement ends at a separator, so this bounds the count; growing the
+    // vector instead would move each Instruction several times
+    size_t separators = 0;
+    for (char c : text) separators += (c == ';' || c == '\n');
+    out.reserve(out.size() + separators + 1);
+    if (!ProgramParser(text, error).parse(out)) return false;
+    // Checked before anything is flattened; counting does not allocate
+    uint64_t length = count_instructions(out);
+    if (length > MAX_PROGRAM_LENGTH) {
+        error.message = "program expands to " + std::to_string(length) + " instructions (limit " +
+                        std::to_string(MAX_PROGRAM_LENGTH) + ")";
+        return false;
+    }
+    return true;
+}
+
+bool read_program_file(const std::string& path, const std::function<bool(std::string_view)>& use, ParseError& error) {
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error.message = "cannot open " + path;
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return use(text);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error.message = "cannot open " + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        error.message = "cannot read " + path;
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        close(fd);
+        return use(std::string_view());
+    }
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        error.message = "cannot map " + path;
+        return false;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    bool ok = use(std::string_view(static_cast<const char*>(data), size));
+    munmap(data, size);
+    return ok;
+#endif
+}
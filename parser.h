@@ -0,0 +1,43 @@
+#ifndef CSOPESY_PARSER_H
+#define CSOPESY_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Instruction;
+
+// Deepest FOR nesting flatten_instructions will expand
+constexpr int MAX_FOR_NESTING = 3;
+// Most instructions a program may expand to once its FOR loops are flattened;
+// nested repeat counts multiply, so a one-line program could otherwise need billions
+constexpr uint64_t MAX_PROGRAM_LENGTH = 1000000;
+
+// First problem found in a program; line and column are 1-based
+struct ParseError {
+    size_t line = 0;      // 0 when the error is not about the text (e.g. a missing file)
+    size_t column = 0;
+    std::string message;
+    // "line 2, column 9: expected a number"
+    std::string describe() const;
+};
+
+// Parses screen -c syntax in one pass over `text`, without copying it:
+//   statements are separated by ';' or newlines, '#' comments out the rest
+//   of a line, and instruction names are case-insensitive
+//   PRINT <text>                 DECLARE <var> <0-65535>
+//   ADD <dst> <op> <op>          SUBTRACT <dst> <op> <op>
+//   READ <var> <address>         WRITE <address> <var>
+//   SLEEP <0-255>                FOR <repeats> { <statements> }   (nested up to 3 deep)
+// Programs that would flatten to more than MAX_PROGRAM_LENGTH instructions are rejected.
+// Returns false with `error` set at the first problem; `out` is then incomplete.
+bool parse_program(std::string_view text, std::vector<Instruction>& out, ParseError& error);
+
+// Calls `use` with the text of `path`, memory-mapped where the platform allows;
+// the view is only valid during the call
+bool read_program_file(const std::string& path, const std::function<bool(std::string_view)>& use, ParseError& error);
+
+#endif // CSOPESY_PARSER_H
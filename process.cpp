@@ -5,7 +5,7 @@
 #include <sstream>
 #include <iomanip>
 
-static bool flatten_instructions(const std::vector<Instruction>& instructions, std::vector<Instruction>& flatInst, int loopDepth = 0) {
+bool flatten_instructions(const std::vector<Instruction>& instructions, std::vector<Instruction>& flatInst, int loopDepth) {
     if (loopDepth > 3)
         return false; // prevents nesting beyond 3 levels
 
@@ -25,29 +25,52 @@ static bool flatten_instructions(const std::vector<Instruction>& instructions, s
     return true;
 }
 
+uint64_t count_instructions(const std::vector<Instruction>& instructions, int loopDepth) {
+    uint64_t count = 0;
+    for (const Instruction& instr : instructions) {
+        if (instr.type != FOR_LOOP) {
+            count++;
+        } else if (loopDepth < 3) {
+            count += static_cast<uint64_t>(instr.val1) * count_instructions(instr.instrSet, loopDepth + 1);
+        }
+    }
+    return count;
+}
+
+uint64_t ProcessControlBlock::staticLength() const {
+    if (staticInstructionCount < 0) {
+        staticInstructionCount = static_cast<int64_t>(flattenedInstructions ? flattenedInstructions->size()
+                                                                            : count_instructions(sourceProgram()));
+    }
+    return static_cast<uint64_t>(staticInstructionCount);
+}
+
+std::shared_ptr<const std::vector<Instruction>> flatten_program(ProcessControlBlock& pcb) {
+    auto flat = std::make_shared<std::vector<Instruction>>();
+    if (!flatten_instructions(pcb.process->instructions, *flat, 0)) {
+        flat->clear();
+        pcb.appendLog("Error: Maximum FOR_LOOP nesting depth exceeded.");
+    }
+    return flat;
+}
+
 void execute_instruction(ProcessControlBlock& pcb, int core_id) {
     if (pcb.processState == State::BLOCKED || pcb.sleepTicks > 0) { // returns early if the process is blocked/sleeping
         return;
     }
 
-    if (!pcb.isFlattened) { // flattens instructions during the first execution (initial value of isFlattened is false)
-        pcb.flattenedInstructions.clear(); 
-        bool success = flatten_instructions(pcb.process->instructions, pcb.flattenedInstructions, 0);
-        pcb.isFlattened = true;
-
-        if (!success) {
-            pcb.flattenedInstructions.clear();
-            pcb.logs.push_back("Error: Maximum FOR_LOOP nesting depth exceeded.");
-        }
+    if (!pcb.flattenedInstructions) { // admission prepares every program; this only covers a PCB that skipped it
+        pcb.flattenedInstructions = flatten_program(pcb);
         pcb.programCounter = 0;
     }
+    const std::vector<Instruction>& program = *pcb.flattenedInstructions;
     
-    if (pcb.programCounter < 0 || pcb.programCounter >= static_cast<int>(pcb.flattenedInstructions.size())) {
+    if (pcb.programCounter < 0 || pcb.programCounter >= static_cast<int>(program.size())) {
         pcb.processState = State::TERMINATED;
         return;
     }
 
-    Instruction& instruction = pcb.flattenedInstructions[pcb.programCounter];
+    const Instruction& instruction = program[pcb.programCounter];
     pcb.processState = State::RUNNING;
 
     switch (instruction.type) {
@@ -130,7 +153,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                 }
             }
             
-            pcb.logs.push_back(log_format(core_id, output));
+            pcb.appendLog(log_format(core_id, output));
             break;
         }
         case DECLARE: {
@@ -149,13 +172,13 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                         pcb.memoryViolationTime = get_timestamp();
                         pcb.memoryViolationAddress = 0;
                         pcb.processState = State::TERMINATED;
-                        pcb.logs.push_back(log_format(core_id, "Symbol table page fault - cannot declare variable"));
+                        pcb.appendLog(log_format(core_id, "Symbol table page fault - cannot declare variable"));
                         break;
                     }
                 }
                 
                 if (!pcb.writeVariable(varName, value)) {
-                    pcb.logs.push_back(log_format(core_id, "Error: Symbol table full, cannot create variable " + varName));
+                    pcb.appendLog(log_format(core_id, "Error: Symbol table full, cannot create variable " + varName));
                 }
             } else {
                 // Legacy memory for random-generated processes
@@ -180,7 +203,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                 uint16_t resultVal = clamp_uint16(sum);
                 
                 if (!pcb.writeVariable(result, resultVal)) {
-                    pcb.logs.push_back(log_format(core_id, "Error: Symbol table full, cannot store result"));
+                    pcb.appendLog(log_format(core_id, "Error: Symbol table full, cannot store result"));
                 }
             } else {
                 // Legacy memory for random-generated processes
@@ -218,7 +241,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                 uint16_t resultVal = clamp_uint16(diff);
                 
                 if (!pcb.writeVariable(result, resultVal)) {
-                    pcb.logs.push_back(log_format(core_id, "Error: Symbol table full, cannot store result"));
+                    pcb.appendLog(log_format(core_id, "Error: Symbol table full, cannot store result"));
                 }
             } else {
                 // Legacy memory for random-generated processes
@@ -242,7 +265,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
         case SLEEP: {
             // sleeps the current process for uint8 CPU ticks and relinquishes the CPU
             pcb.sleepTicks = static_cast<uint8_t>(std::min<uint16_t>(instruction.val1, 255)); // clamped to uint8_t
-            pcb.processState = State::BLOCKED;
+            if (pcb.sleepTicks > 0) pcb.processState = State::BLOCKED; // SLEEP 0 would never be woken
             break;
         }
         case FOR_LOOP: {
@@ -264,7 +287,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                 if (parse_integer(addrStr, addr_int) && addr_int >= 0) {
                     address = static_cast<size_t>(addr_int);
                 } else {
-                    pcb.logs.push_back(log_format(core_id, "Error: Invalid address format " + addrStr));
+                    pcb.appendLog(log_format(core_id, "Error: Invalid address format " + addrStr));
                     break;
                 }
             }
@@ -278,7 +301,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                 pcb.processState = State::TERMINATED;
                 std::ostringstream oss;
                 oss << "Memory access violation at 0x" << std::hex << std::uppercase << address;
-                pcb.logs.push_back(log_format(core_id, oss.str()));
+                pcb.appendLog(log_format(core_id, oss.str()));
                 break;
             }
             
@@ -290,7 +313,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                     pcb.memoryViolationTime = get_timestamp();
                     pcb.memoryViolationAddress = address;
                     pcb.processState = State::TERMINATED;
-                    pcb.logs.push_back(log_format(core_id, "Memory access failed"));
+                    pcb.appendLog(log_format(core_id, "Memory access failed"));
                     break;
                 }
             }
@@ -300,7 +323,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
             
             // Store in variable (symbol table)
             if (!pcb.writeVariable(varName, value)) {
-                pcb.logs.push_back(log_format(core_id, "Error: Symbol table full, cannot create variable " + varName));
+                pcb.appendLog(log_format(core_id, "Error: Symbol table full, cannot create variable " + varName));
             }
             break;
         }
@@ -318,7 +341,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                 if (parse_integer(addrStr, addr_int) && addr_int >= 0) {
                     address = static_cast<size_t>(addr_int);
                 } else {
-                    pcb.logs.push_back(log_format(core_id, "Error: Invalid address format " + addrStr));
+                    pcb.appendLog(log_format(core_id, "Error: Invalid address format " + addrStr));
                     break;
                 }
             }
@@ -332,7 +355,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                 pcb.processState = State::TERMINATED;
                 std::ostringstream oss;
                 oss << "Memory access violation at 0x" << std::hex << std::uppercase << address;
-                pcb.logs.push_back(log_format(core_id, oss.str()));
+                pcb.appendLog(log_format(core_id, oss.str()));
                 break;
             }
             
@@ -344,7 +367,7 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                     pcb.memoryViolationTime = get_timestamp();
                     pcb.memoryViolationAddress = address;
                     pcb.processState = State::TERMINATED;
-                    pcb.logs.push_back(log_format(core_id, "Memory access failed"));
+                    pcb.appendLog(log_format(core_id, "Memory access failed"));
                     break;
                 }
             }
@@ -360,18 +383,22 @@ void execute_instruction(ProcessControlBlock& pcb, int core_id) {
                 pcb.processState = State::TERMINATED;
                 std::ostringstream oss;
                 oss << "Memory write failed at 0x" << std::hex << std::uppercase << address;
-                pcb.logs.push_back(log_format(core_id, oss.str()));
+                pcb.appendLog(log_format(core_id, oss.str()));
             }
             break;
         }
     }
 
-    if (pcb.processState == State::BLOCKED || pcb.processState == State::TERMINATED)
+    if (pcb.processState == State::TERMINATED)
+        return;
+    if (pcb.processState == State::BLOCKED) {
+        pcb.programCounter++; // resume after the SLEEP once woken
         return;
+    }
     
     pcb.programCounter++;
 
-    if (pcb.programCounter >= static_cast<int>(pcb.flattenedInstructions.size())) {
+    if (pcb.programCounter >= static_cast<int>(program.size())) {
         pcb.processState = State::TERMINATED;
     } else {
         pcb.processState = State::READY;
@@ -6,6 +6,10 @@
 #include <unordered_map>
 #include <cstdint>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <mutex>
 #include "utils.h"
 
 enum InstructionType {
@@ -40,6 +44,10 @@ constexpr size_t MAX_VARIABLES = 32;          // Max 32 UINT16 variables (2 byte
 constexpr size_t MIN_MEMORY_SIZE = 64;        // Minimum 2^6 bytes
 constexpr size_t MAX_MEMORY_SIZE = 65536;     // Maximum 2^16 bytes
 
+// Priority scheduler levels: 0 is the most urgent
+constexpr int NUM_PRIORITY_LEVELS = 32;
+constexpr int DEFAULT_PRIORITY = NUM_PRIORITY_LEVELS / 2;
+
 struct Process {
     int pid;
     std::string name;
@@ -47,6 +55,13 @@ struct Process {
     size_t memorySize = 0;                     // Total allocated memory size
 };
 
+// A parsed program and its flattened image; processes submitted with the same
+// text share one through the program cache
+struct CompiledProgram {
+    std::vector<Instruction> instructions;     // as written, FOR blocks intact
+    std::vector<Instruction> flattened;        // what the cores execute
+};
+
 struct ProcessControlBlock {
     std::unique_ptr<Process> process;
     State processState = READY;
@@ -54,9 +69,10 @@ struct ProcessControlBlock {
     uint8_t sleepTicks = 0;
     int nestingDepth = 0; 
     std::unordered_map<std::string, uint16_t> memory;  // Legacy memory for DECLARE/ADD/SUBTRACT
-    std::vector<std::string> logs;
-    std::vector<Instruction> flattenedInstructions;
-    bool isFlattened = false;
+    std::vector<std::string> logs;                     // appended under logMutex while the process is live
+    mutable std::mutex logMutex;
+    std::shared_ptr<const CompiledProgram> program;  // cached program (process->instructions is then empty)
+    std::shared_ptr<const std::vector<Instruction>> flattenedInstructions; // null until flattened; may point into program
     
     // New memory management for READ/WRITE instructions
     std::vector<uint8_t> processMemory;                // Process memory buffer
@@ -67,7 +83,101 @@ struct ProcessControlBlock {
     bool hasMemoryViolation = false;
     std::string memoryViolationTime;
     size_t memoryViolationAddress = 0;
+
+    int priority = DEFAULT_PRIORITY;
+    mutable int64_t staticInstructionCount = -1;  // computed on first use
+    int nice = 0;                         // CFS weight, -20 (most CPU) to 19
+    uint64_t vruntime = 0;                // CFS: weighted instructions run (1024 = one instruction at nice 0)
+    int timeSlice = 0;                    // CFS: slice chosen at dispatch
+    int mlfqLevel = 0;                    // MLFQ queue level (0 = top)
+    uint64_t mlfqEpoch = 0;               // boost epoch mlfqLevel belongs to
+
+    // EDF real-time class (rtPeriod == 0: best effort). Job k is released at
+    // arrivalTick + k * rtPeriod and runs the whole program once.
+    uint64_t rtPeriod = 0;
+    uint64_t rtDeadline = 0;              // relative to each job's release
+    int rtJobs = 1;
+    int rtJobsDone = 0;
+    bool rtAwaitingRelease = false;       // blocked until the next job's release
+    int deadlineMisses = 0;
+    uint64_t maxLateness = 0;             // worst finish past a deadline, in ticks
+
+    // Set by the ready queue on every enqueue (scheduling latency)
+    std::chrono::steady_clock::time_point readySince;
+    // Priority policy: aged rank (smaller runs first); kept when an arrival preempts the process
+    uint64_t agedPriorityKey = 0;
+
+    // Scheduling timeline, in CPU ticks (cpuCycles)
+    bool arrived = false;                 // set when added to the process registry
+    bool hasRun = false;
+    std::string arrivalTime;              // wall-clock arrival time
+    uint64_t arrivalTick = 0;
+    uint64_t firstRunTick = 0;
+    uint64_t finishTick = 0;
+    uint64_t readySinceTick = 0;
+    uint64_t waitingTicks = 0;            // total time spent in the ready queue
+    uint64_t runTicks = 0;                // total time on a core
+    int quantaRun = 0;                    // number of dispatches
+    int lastCore = -1;                    // core that ran it last (-1 = never ran)
+    int migrations = 0;                   // dispatches on a different core than lastCore
+
+    // Progress mirror written by the owning core, read by the snapshot publisher
+    std::atomic<uint64_t> publishedProgress{0};  // total << 32 | counter, so readers never mix two programs
+    std::atomic<uint64_t> publishedVruntime{0};   // updated when the process leaves a core
+    std::atomic<uint64_t> publishedRunTicks{0};
+    std::atomic<int> publishedJobsDone{0};
+    std::atomic<int> publishedDeadlineMisses{0};
+    std::atomic<uint64_t> publishedMaxLateness{0};
+    std::atomic<int> publishedCore{-1};
+
+    void publishProgress() {
+        uint32_t total = static_cast<uint32_t>(flattenedInstructions ? flattenedInstructions->size() : sourceProgram().size());
+        uint32_t counter = static_cast<uint32_t>(std::max(0, programCounter));
+        publishedProgress.store(static_cast<uint64_t>(total) << 32 | counter, std::memory_order_relaxed);
+    }
+    // Counter and total from the same publishProgress call
+    void readProgress(int& counter, int& total) const {
+        uint64_t progress = publishedProgress.load(std::memory_order_relaxed);
+        counter = static_cast<int>(progress & 0xFFFFFFFFu);
+        total = static_cast<int>(progress >> 32);
+    }
     
+    // The core appends while process-smi may be copying, so both hold logMutex
+    void appendLog(std::string line) {
+        std::lock_guard<std::mutex> lock(logMutex);
+        logs.push_back(std::move(line));
+    }
+    std::vector<std::string> copyLogs() const {
+        std::lock_guard<std::mutex> lock(logMutex);
+        return logs;
+    }
+
+    // Runs a compiled program; the process shares its flattened image instead of building one
+    void setProgram(std::shared_ptr<const CompiledProgram> compiled) {
+        flattenedInstructions = std::shared_ptr<const std::vector<Instruction>>(compiled, &compiled->flattened);
+        program = std::move(compiled);
+    }
+
+    // The program as written: the shared cached copy, or the process's own
+    const std::vector<Instruction>& sourceProgram() const {
+        return program ? program->instructions : process->instructions;
+    }
+
+    // Static program length: instruction count with FOR_LOOP bodies expanded (cached)
+    uint64_t staticLength() const;
+    uint64_t remainingInstructions() const {
+        uint64_t total = staticLength();
+        uint64_t done = static_cast<uint64_t>(std::max(0, programCounter));
+        return total > done ? total - done : 0;
+    }
+
+    uint64_t rtJobRelease() const { return arrivalTick + static_cast<uint64_t>(rtJobsDone) * rtPeriod; }
+    uint64_t rtAbsoluteDeadline() const { return rtJobRelease() + rtDeadline; }
+    // Worst-case share of one core: instructions per job over the period
+    double rtUtilization() const {
+        return rtPeriod > 0 ? static_cast<double>(staticLength()) / static_cast<double>(rtPeriod) : 0.0;
+    }
+
     // Initialize process memory with given size
     void initializeMemory(size_t size) {
         processMemory.resize(size, 0);  // Zero-initialized
@@ -128,6 +238,12 @@ struct ProcessControlBlock {
     }
 };
 
+// Expands FOR_LOOP bodies into a straight-line program; false if nesting exceeds 3 levels
+bool flatten_instructions(const std::vector<Instruction>& instructions, std::vector<Instruction>& flatInst, int loopDepth = 0);
+// Number of instructions flatten_instructions would produce, without building them
+uint64_t count_instructions(const std::vector<Instruction>& instructions, int loopDepth = 0);
+// Flattened image of the process's own program; logs an error and returns an empty program if nesting is too deep
+std::shared_ptr<const std::vector<Instruction>> flatten_program(ProcessControlBlock& pcb);
 void execute_instruction(ProcessControlBlock& pcb, int core_id);
 
 #endif
\ No newline at end of file
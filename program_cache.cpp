@@ -0,0 +1,137 @@
+#include "program_cache.h"
+#include "parser.h"
+#include "process.h"
+
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+struct CacheEntry {
+    uint64_t hash;
+    std::string text;   // compared on lookup, so a hash collision is a miss rather than the wrong program
+    std::shared_ptr<const CompiledProgram> program;
+};
+
+static std::mutex cache_mutex; // guards everything below
+static std::list<CacheEntry> lru; // most recently used first
+static std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> index_by_hash;
+static size_t capacity = DEFAULT_PROGRAM_CACHE_SIZE;
+static ProgramCacheStats stats;
+
+// 64-bit FNV-1a
+static uint64_t hash_text(std::string_view text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static void erase_entry(std::list<CacheEntry>::iterator it) {
+    stats.instructions -= it->program->flattened.size();
+    index_by_hash.erase(it->hash);
+    lru.erase(it);
+}
+
+static void evict_to(size_t entries) {
+    while (lru.size() > entries || stats.instructions > PROGRAM_CACHE_MAX_INSTRUCTIONS) {
+        erase_entry(std::prev(lru.end()));
+        stats.evictions++;
+    }
+}
+
+std::shared_ptr<const CompiledProgram> compile_program(std::string_view text, ParseError& error) {
+    // Surrounding whitespace does not change the program, so it does not change the key either
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos) text = std::string_view();
+    else text = text.substr(start, text.find_last_not_of(" \t\r\n") - start + 1);
+    uint64_t hash = hash_text(text);
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto found = index_by_hash.find(hash);
+        if (found != index_by_hash.end() && found->second->text == text) {
+            lru.splice(lru.begin(), lru, found->second);
+            stats.hits++;
+            return found->second->program;
+        }
+        stats.misses++;
+    }
+
+    // Compiled outside the lock so a large program does not hold up other submitters
+    auto program = std::make_shared<CompiledProgram>();
+    if (!parse_program(text, program->instructions, error)) return nullptr;
+    // Sized before flattening, so an oversized program is refused without allocating it
+    uint64_t length = count_instructions(program->instructions);
+    if (length > MAX_PROGRAM_LENGTH) {
+        error.message = "program expands to " + std::to_string(length) + " instructions (limit " +
+                        std::to_string(MAX_PROGRAM_LENGTH) + ")";
+        return nullptr;
+    }
+    program->flattened.reserve(static_cast<size_t>(length));
+    if (!flatten_instructions(program->instructions, program->flattened)) {
+        error.message = "FOR loops nest too deep to expand";
+        return nullptr;
+    }
+    std::shared_ptr<const CompiledProgram> compiled = std::move(program);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (capacity == 0 || compiled->flattened.size() > PROGRAM_CACHE_MAX_INSTRUCTIONS) return compiled;
+    auto found = index_by_hash.find(hash);
+    if (found != index_by_hash.end()) {
+        // Another submitter compiled the same text meanwhile: share theirs
+        if (found->second->text == text) {
+            lru.splice(lru.begin(), lru, found->second);
+            return found->second->program;
+        }
+        erase_entry(found->second); // same hash, different text; the newer program wins
+    }
+    lru.push_front(CacheEntry{hash, std::string(text), compiled});
+    index_by_hash[hash] = lru.begin();
+    stats.instructions += compiled->flattened.size();
+    evict_to(capacity);
+    return compiled;
+}
+
+std::shared_ptr<const CompiledProgram> compile_program_file(const std::string& path, ParseError& error) {
+    std::shared_ptr<const CompiledProgram> compiled;
+    read_program_file(path, [&](std::string_view text) {
+        compiled = compile_program(text, error);
+        return compiled != nullptr;
+    }, error);
+    return compiled;
+}
+
+void set_program_cache_capacity(size_t entries) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    capacity = entries;
+    evict_to(capacity);
+}
+
+void clear_program_cache() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    lru.clear();
+    index_by_hash.clear();
+    stats = ProgramCacheStats{};
+}
+
+ProgramCacheStats program_cache_stats() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    ProgramCacheStats out = stats;
+    out.entries = lru.size();
+    out.capacity = capacity;
+    return out;
+}
+
+std::string format_program_cache() {
+    ProgramCacheStats s = program_cache_stats();
+    if (s.capacity == 0) return "Program cache: off\n";
+    uint64_t lookups = s.hits + s.misses;
+    std::string out = "Program cache: " + std::to_string(s.entries) + "/" + std::to_string(s.capacity) + " programs (" +
+                      std::to_string(s.instructions) + " instructions), " + std::to_string(s.hits) + " hits, " +
+                      std::to_string(s.misses) + " misses";
+    if (lookups > 0) out += " (" + std::to_string(s.hits * 100 / lookups) + "% hit)";
+    out += ", " + std::to_string(s.evictions) + " evictions\n";
+    return out;
+}
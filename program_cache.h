@@ -0,0 +1,44 @@
+#ifndef CSOPESY_PROGRAM_CACHE_H
+#define CSOPESY_PROGRAM_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+struct CompiledProgram;
+struct ParseError;
+
+// Compiled programs keyed by a hash of their text. Submitting a program that
+// is already cached skips parsing and flattening: the new process shares the
+// cached image. Entries are evicted least recently used first.
+constexpr size_t DEFAULT_PROGRAM_CACHE_SIZE = 64;
+// Flattened instructions the cache may hold in total, whatever the entry count;
+// a program longer than this is compiled but not kept
+constexpr size_t PROGRAM_CACHE_MAX_INSTRUCTIONS = 4000000;
+
+// Parses and flattens `text`, or returns the cached image of identical text.
+// nullptr with `error` set if the program does not parse or would flatten to more
+// than MAX_PROGRAM_LENGTH instructions; failures are not cached.
+std::shared_ptr<const CompiledProgram> compile_program(std::string_view text, ParseError& error);
+// compile_program over the contents of a file (screen -f)
+std::shared_ptr<const CompiledProgram> compile_program_file(const std::string& path, ParseError& error);
+
+// Entries kept (program-cache-size; 0 turns the cache off); shrinking evicts
+void set_program_cache_capacity(size_t entries);
+void clear_program_cache();
+
+struct ProgramCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t capacity = 0;
+    size_t instructions = 0;  // flattened instructions held by cached entries
+};
+ProgramCacheStats program_cache_stats();
+// One vmstat line
+std::string format_program_cache();
+
+#endif // CSOPESY_PROGRAM_CACHE_H
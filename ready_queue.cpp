@@ -0,0 +1,266 @@
+#include "ready_queue.h"
+#include "process.h"
+#include "metrics.h"
+#include "globals.h"
+
+#include <algorithm>
+
+SchedulerPolicy parse_scheduler_policy(const std::string& name, bool& ok) {
+    ok = true;
+    if (name == "rr") return SchedulerPolicy::RR;
+    if (name == "fcfs") return SchedulerPolicy::FCFS;
+    if (name == "priority") return SchedulerPolicy::Priority;
+    if (name == "mlfq") return SchedulerPolicy::MLFQ;
+    if (name == "sjf") return SchedulerPolicy::SJF;
+    if (name == "srtf") return SchedulerPolicy::SRTF;
+    if (name == "cfs") return SchedulerPolicy::CFS;
+    if (name == "edf") return SchedulerPolicy::EDF;
+    ok = false;
+    return SchedulerPolicy::FCFS;
+}
+
+const char* scheduler_policy_name(SchedulerPolicy policy) {
+    switch (policy) {
+        case SchedulerPolicy::RR: return "rr";
+        case SchedulerPolicy::Priority: return "priority";
+        case SchedulerPolicy::MLFQ: return "mlfq";
+        case SchedulerPolicy::SJF: return "sjf";
+        case SchedulerPolicy::SRTF: return "srtf";
+        case SchedulerPolicy::CFS: return "cfs";
+        case SchedulerPolicy::EDF: return "edf";
+        case SchedulerPolicy::FCFS: break;
+    }
+    return "fcfs";
+}
+
+uint32_t nice_to_weight(int nice) {
+    // Same table as the Linux scheduler: each nice step is ~10% more or less CPU
+    static const uint32_t weights[40] = {
+        88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+        9548,  7620,  6100,  4904,  3906,  3121,  2501,  1991,  1586,  1277,
+        1024,  820,   655,   526,   423,   335,   272,   215,   172,   137,
+        110,   87,    70,    56,    45,    36,    29,    23,    18,    15,
+    };
+    return weights[std::max(-20, std::min(19, nice)) + 20];
+}
+
+void ReadyQueue::configure(SchedulerPolicy policy, int numCores, uint64_t agingCycles) {
+    currentPolicy = policy;
+    coreCount = std::max(1, std::min(numCores, MAX_SCHEDULER_CORES));
+    aging = agingCycles;
+    for (auto& slot : slots) {
+        slot.busy = false;
+        slot.preempt = false;
+    }
+}
+
+void ReadyQueue::setCoreCount(int numCores) {
+    coreCount = std::max(1, std::min(numCores, MAX_SCHEDULER_CORES));
+}
+
+void ReadyQueue::configureLevels(int count, uint64_t boostCycles) {
+    levels.assign(currentPolicy == SchedulerPolicy::MLFQ ? static_cast<size_t>(std::max(1, count)) : 0, {});
+    levelTotal = 0;
+    boostInterval = boostCycles;
+    lastBoostTick = static_cast<uint64_t>(cpuCycles.load());
+}
+
+void ReadyQueue::configureFair(int latency, int granularity) {
+    targetLatency = std::max(1, latency);
+    minGranularity = std::max(1, granularity);
+    minVruntime = 0;
+    readyWeight = 0;
+}
+
+void ReadyQueue::configureAffinity(int window) {
+    affinityWindow = std::max(0, window);
+    headSkips = 0;
+}
+
+std::vector<size_t> ReadyQueue::levelDepths() const {
+    std::vector<size_t> depths;
+    for (const auto& level : levels) depths.push_back(level.size());
+    return depths;
+}
+
+void ReadyQueue::clear() {
+    fifo.clear();
+    ordered.clear();
+    for (auto& level : levels) level.clear();
+    levelTotal = 0;
+    readyWeight = 0;
+}
+
+// Moves every waiting process to the top level; running ones follow when they
+// are next enqueued (their epoch is stale)
+void ReadyQueue::boost() {
+    boostEpoch++;
+    for (size_t i = 1; i < levels.size(); ++i) {
+        for (auto& pcb : levels[i]) {
+            pcb->mlfqLevel = 0;
+            pcb->mlfqEpoch = boostEpoch;
+            levels[0].push_back(std::move(pcb));
+        }
+        levels[i].clear();
+    }
+}
+
+uint64_t ReadyQueue::orderKey(const ProcessControlBlock& pcb) const {
+    switch (currentPolicy) {
+        case SchedulerPolicy::Priority:
+            // Aging: every `aging` cycles spent waiting is worth one priority level,
+            // so a process's rank is fixed at enqueue time and the tree never needs re-sorting
+            return pcb.agedPriorityKey;
+        case SchedulerPolicy::SJF:
+            return pcb.staticLength();
+        case SchedulerPolicy::SRTF:
+            return pcb.remainingInstructions();
+        case SchedulerPolicy::CFS:
+            return pcb.vruntime;
+        case SchedulerPolicy::EDF:
+            return pcb.rtAbsoluteDeadline();
+        default:
+            return 0;
+    }
+}
+
+uint64_t ReadyQueue::preemptRank(const ProcessControlBlock& pcb) const {
+    switch (currentPolicy) {
+        // Same aged key as the queue order, so a newcomer preempts only a process it would have run before
+        case SchedulerPolicy::Priority: return pcb.agedPriorityKey;
+        case SchedulerPolicy::MLFQ: return static_cast<uint64_t>(pcb.mlfqLevel);
+        case SchedulerPolicy::SRTF: return pcb.remainingInstructions();
+        // Best-effort processes rank below every deadline
+        case SchedulerPolicy::EDF: return isRealtime(pcb) ? pcb.rtAbsoluteDeadline() : UINT64_MAX;
+        default: return 0;
+    }
+}
+
+bool ReadyQueue::isRealtime(const ProcessControlBlock& pcb) const {
+    return currentPolicy == SchedulerPolicy::EDF && pcb.rtPeriod > 0;
+}
+
+void ReadyQueue::updateRunning(int core, const ProcessControlBlock& pcb) {
+    if (core < 0 || core >= MAX_SCHEDULER_CORES) return;
+    slots[core].rank.store(preemptRank(pcb), std::memory_order_relaxed);
+}
+
+void ReadyQueue::maybePreempt(const ProcessControlBlock& pcb) {
+    if (!isPreemptive()) return;
+    // Preempt the core running the least urgent process, if the newcomer outranks it.
+    // An idle core will pick the newcomer up anyway.
+    int victim = -1;
+    uint64_t worst = 0;
+    uint64_t rank = preemptRank(pcb);
+    for (int c = 0; c < coreCount; ++c) {
+        const CoreSlot& slot = slots[c];
+        if (!slot.busy.load(std::memory_order_relaxed)) return;
+        if (slot.preempt.load(std::memory_order_relaxed)) continue;
+        uint64_t running = slot.rank.load(std::memory_order_relaxed);
+        if (running > rank && (victim < 0 || running > worst)) {
+            victim = c;
+            worst = running;
+        }
+    }
+    if (victim >= 0) slots[victim].preempt.store(true, std::memory_order_relaxed);
+}
+
+std::shared_ptr<ProcessControlBlock> ReadyQueue::takeAffine(std::deque<std::shared_ptr<ProcessControlBlock>>& queue,
+                                                             int core) {
+    // The head is passed over at most affinityWindow times in a row, so it cannot starve
+    if (core >= 0 && headSkips < affinityWindow && queue.front()->lastCore != core) {
+        size_t limit = std::min(queue.size(), static_cast<size_t>(affinityWindow) + 1);
+        for (size_t i = 1; i < limit; ++i) {
+            if (queue[i]->lastCore != core) continue;
+            auto pcb = std::move(queue[i]);
+            queue.erase(queue.begin() + static_cast<std::ptrdiff_t>(i));
+            headSkips++;
+            return pcb;
+        }
+    }
+    headSkips = 0;
+    auto pcb = std::move(queue.front());
+    queue.pop_front();
+    return pcb;
+}
+
+void ReadyQueue::push(const std::shared_ptr<ProcessControlBlock>& pcb, bool preempted) {
+    pcb->readySince = std::chrono::steady_clock::now();
+    pcb->readySinceTick = static_cast<uint64_t>(cpuCycles.load());
+    if (currentPolicy == SchedulerPolicy::Priority && !preempted) {
+        pcb->agedPriorityKey = pcb->readySinceTick + static_cast<uint64_t>(pcb->priority) * aging;
+    }
+    if (currentPolicy == SchedulerPolicy::CFS) {
+        // New and waking processes start no earlier than the queue's floor, so a
+        // long sleeper cannot monopolize a core to "catch up"
+        pcb->vruntime = std::max(pcb->vruntime, minVruntime);
+        readyWeight += nice_to_weight(pcb->nice);
+    }
+    if (isOrdered() || isRealtime(*pcb)) {
+        ordered.emplace(orderKey(*pcb), pcb);
+        maybePreempt(*pcb);
+    } else if (!levels.empty()) {
+        if (pcb->mlfqEpoch != boostEpoch) {
+            pcb->mlfqLevel = 0;
+            pcb->mlfqEpoch = boostEpoch;
+        }
+        int level = std::max(0, std::min(pcb->mlfqLevel, static_cast<int>(levels.size()) - 1));
+        levels[level].push_back(pcb);
+        levelTotal++;
+        maybePreempt(*pcb);
+    } else {
+        fifo.push_back(pcb);
+    }
+}
+
+std::shared_ptr<ProcessControlBlock> ReadyQueue::pop(int core) {
+    std::shared_ptr<ProcessControlBlock> pcb;
+    if (levelTotal > 0) {
+        uint64_t tick = static_cast<uint64_t>(cpuCycles.load());
+        if (boostInterval > 0 && tick - lastBoostTick >= boostInterval) {
+            boost();
+            lastBoostTick = tick;
+        }
+        for (auto& level : levels) {
+            if (level.empty()) continue;
+            pcb = takeAffine(level, core);
+            levelTotal--;
+            break;
+        }
+    } else if (!ordered.empty()) {
+        auto first = ordered.begin();
+        pcb = std::move(first->second);
+        ordered.erase(first);
+        if (currentPolicy == SchedulerPolicy::CFS) {
+            uint64_t weight = nice_to_weight(pcb->nice);
+            readyWeight -= std::min(readyWeight, weight);
+            minVruntime = std::max(minVruntime, pcb->vruntime);
+            // Slice: this process's weighted share of one target-latency period per core
+            uint64_t slice = static_cast<uint64_t>(targetLatency) * static_cast<uint64_t>(coreCount) * weight /
+                             (readyWeight + weight);
+            pcb->timeSlice = static_cast<int>(std::max<uint64_t>(static_cast<uint64_t>(minGranularity), slice));
+        }
+    } else if (!fifo.empty()) {
+        pcb = takeAffine(fifo, core);
+    } else {
+        return nullptr;
+    }
+    auto waited = std::chrono::steady_clock::now() - pcb->readySince;
+    scheduling_latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()));
+    uint64_t now = static_cast<uint64_t>(cpuCycles.load());
+    if (now > pcb->readySinceTick) pcb->waitingTicks += now - pcb->readySinceTick;
+
+    if (core >= 0 && core < MAX_SCHEDULER_CORES) {
+        CoreSlot& slot = slots[core];
+        slot.rank.store(preemptRank(*pcb), std::memory_order_relaxed);
+        slot.preempt.store(false, std::memory_order_relaxed);
+        slot.busy.store(true, std::memory_order_relaxed);
+    }
+    return pcb;
+}
+
+void ReadyQueue::release(int core) {
+    if (core < 0 || core >= MAX_SCHEDULER_CORES) return;
+    slots[core].busy.store(false, std::memory_order_relaxed);
+    slots[core].preempt.store(false, std::memory_order_relaxed);
+}
@@ -0,0 +1,124 @@
+#ifndef CSOPESY_READY_QUEUE_H
+#define CSOPESY_READY_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ProcessControlBlock;
+
+// Scheduling policy, parsed once from the config 'scheduler' key
+enum class SchedulerPolicy {
+    FCFS,
+    RR,
+    Priority,  // preemptive, RR among equal priorities, with aging
+    MLFQ,      // multilevel feedback queue with periodic boost
+    SJF,       // shortest job first (static instruction count), non-preemptive
+    SRTF,      // shortest remaining time first, preemptive
+    CFS,       // completely fair: smallest weighted virtual runtime first
+    EDF        // real-time processes by earliest deadline, then best-effort RR
+};
+
+// Unknown names fall back to FCFS (ok = false)
+SchedulerPolicy parse_scheduler_policy(const std::string& name, bool& ok);
+const char* scheduler_policy_name(SchedulerPolicy policy);
+
+constexpr int MAX_SCHEDULER_CORES = 128;
+
+// CFS load weight for a nice value in [-20, 19] (nice 0 = 1024, ~1.25x per step)
+uint32_t nice_to_weight(int nice);
+constexpr uint32_t NICE_0_WEIGHT = 1024;
+
+// Queue of processes waiting for a core. Not thread-safe on its own:
+// callers hold process_table_mutex, as with the rest of the scheduler state.
+// FIFO policies use a deque, MLFQ one deque per level, and ordered policies a
+// tree keyed by rank (O(log n)). Deque policies prefer a process that last ran
+// on the popping core within a small window; ordered ones keep strict order.
+// EDF keeps real-time processes in the tree and
+// best-effort ones in the deque, which is only served when no deadline is waiting.
+// The queue also tracks what each core is running so an arrival that outranks
+// a running process can ask that core to preempt at the next instruction.
+class ReadyQueue {
+public:
+    // Selects the policy and core count; the queue must be empty
+    void configure(SchedulerPolicy policy, int numCores, uint64_t agingCycles);
+    // MLFQ: number of levels and cycles between priority boosts (0 = never)
+    void configureLevels(int levels, uint64_t boostCycles);
+    // CFS: instructions in which every runnable process should run once, and the shortest slice
+    void configureFair(int targetLatency, int minGranularity);
+    // Cache affinity: how many queued processes a core looks past the head for one it ran last (0 = off)
+    void configureAffinity(int window);
+    // Cores added or removed while running (slots of removed cores are released by their last end_run)
+    void setCoreCount(int numCores);
+    SchedulerPolicy policy() const { return currentPolicy; }
+    int levelCount() const { return static_cast<int>(levels.size()); }
+    // Processes waiting at each MLFQ level (empty for other policies)
+    std::vector<size_t> levelDepths() const;
+
+    // Enqueues a process and stamps the time it became ready. A process an
+    // arrival preempted keeps its aged priority rank rather than starting over.
+    void push(const std::shared_ptr<ProcessControlBlock>& pcb, bool preempted = false);
+    // Dequeues the next process (nullptr if empty) and accounts how long it waited.
+    // With a core id, the process is recorded as running there.
+    std::shared_ptr<ProcessControlBlock> pop(int core = -1);
+    // The core stopped running its process (may be called without the lock)
+    void release(int core);
+    // Set when a higher-ranked process arrived; cleared by the core's next pop
+    bool preemptRequested(int core) const {
+        return core >= 0 && core < MAX_SCHEDULER_CORES && slots[core].preempt.load(std::memory_order_relaxed);
+    }
+    // Refreshes the rank of the process running on `core` (SRTF: remaining work shrinks as it runs)
+    void updateRunning(int core, const ProcessControlBlock& pcb);
+
+    bool empty() const { return size() == 0; }
+    size_t size() const { return fifo.size() + ordered.size() + levelTotal; }
+    void clear();
+
+private:
+    struct CoreSlot {
+        std::atomic<bool> busy{false};
+        std::atomic<bool> preempt{false};
+        std::atomic<uint64_t> rank{0};  // rank of the running process
+    };
+
+    bool isOrdered() const {
+        return currentPolicy == SchedulerPolicy::Priority || currentPolicy == SchedulerPolicy::SJF ||
+               currentPolicy == SchedulerPolicy::SRTF || currentPolicy == SchedulerPolicy::CFS;
+    }
+    // CFS relies on its short dynamic slices instead of arrival preemption
+    bool isPreemptive() const { return currentPolicy != SchedulerPolicy::SJF && currentPolicy != SchedulerPolicy::CFS; }
+    bool isRealtime(const ProcessControlBlock& pcb) const;
+    void boost();
+    // Position in the ready structure (smaller runs first)
+    uint64_t orderKey(const ProcessControlBlock& pcb) const;
+    // Urgency compared against running processes for preemption (smaller is more urgent)
+    uint64_t preemptRank(const ProcessControlBlock& pcb) const;
+    void maybePreempt(const ProcessControlBlock& pcb);
+    // Removes the next process of a FIFO-ordered deque, preferring one that last ran on `core`
+    std::shared_ptr<ProcessControlBlock> takeAffine(std::deque<std::shared_ptr<ProcessControlBlock>>& queue, int core);
+
+    SchedulerPolicy currentPolicy = SchedulerPolicy::FCFS;
+    int coreCount = 1;
+    uint64_t aging = 0;
+    std::deque<std::shared_ptr<ProcessControlBlock>> fifo;
+    std::multimap<uint64_t, std::shared_ptr<ProcessControlBlock>> ordered; // equal keys keep FIFO order
+    std::vector<std::deque<std::shared_ptr<ProcessControlBlock>>> levels;   // MLFQ, level 0 first
+    size_t levelTotal = 0;
+    uint64_t boostInterval = 0;
+    uint64_t lastBoostTick = 0;
+    uint64_t boostEpoch = 0;
+    uint64_t minVruntime = 0;     // CFS: monotonic floor for newly queued processes
+    uint64_t readyWeight = 0;     // CFS: total weight of queued processes
+    int targetLatency = 48;
+    int minGranularity = 2;
+    int affinityWindow = 0;
+    int headSkips = 0;            // consecutive pops that passed over the head for affinity
+    std::array<CoreSlot, MAX_SCHEDULER_CORES> slots;
+};
+
+#endif // CSOPESY_READY_QUEUE_H
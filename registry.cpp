@@ -0,0 +1,89 @@
+#include "registry.h"
+#include "process.h"
+#include "archive.h"
+#include "globals.h"
+#include "utils.h"
+
+#include <mutex>
+
+ProcessRegistry process_registry;
+
+void ProcessRegistry::add(const std::shared_ptr<ProcessControlBlock>& pcb) {
+    if (!pcb || !pcb->process) return;
+    // A process arrives when it becomes visible; stamped before any reader can see it
+    if (!pcb->arrived) {
+        pcb->arrived = true;
+        pcb->arrivalTick = static_cast<uint64_t>(cpuCycles.load());
+        pcb->arrivalTime = get_timestamp();
+    }
+    int pid = pcb->process->pid;
+    const std::string& name = pcb->process->name;
+    {
+        PidStripe& ps = pidStripe(pid);
+        std::unique_lock<std::shared_mutex> lock(ps.mutex);
+        if (ps.live.emplace(pid, pcb).second) numLive++;
+        ps.names[pid] = name;
+    }
+    {
+        NameStripe& ns = nameStripe(name);
+        std::unique_lock<std::shared_mutex> lock(ns.mutex);
+        ns.live[name] = pcb;
+    }
+}
+
+void ProcessRegistry::retire(const std::shared_ptr<ProcessControlBlock>& pcb, std::shared_ptr<const RetiredProcess> record) {
+    if (!pcb || !pcb->process) return;
+    int pid = pcb->process->pid;
+    const std::string& name = pcb->process->name;
+    {
+        PidStripe& ps = pidStripe(pid);
+        std::unique_lock<std::shared_mutex> lock(ps.mutex);
+        if (ps.live.erase(pid) > 0) numLive--;
+    }
+    {
+        NameStripe& ns = nameStripe(name);
+        std::unique_lock<std::shared_mutex> lock(ns.mutex);
+        // A newer process may have reused the name; only drop our own entry
+        auto it = ns.live.find(name);
+        if (it != ns.live.end() && it->second == pcb) ns.live.erase(it);
+        if (record) ns.retired[name] = std::move(record);
+    }
+}
+
+std::shared_ptr<ProcessControlBlock> ProcessRegistry::findByName(const std::string& name) const {
+    const NameStripe& ns = nameStripe(name);
+    std::shared_lock<std::shared_mutex> lock(ns.mutex);
+    auto it = ns.live.find(name);
+    return (it != ns.live.end()) ? it->second : nullptr;
+}
+
+std::shared_ptr<const RetiredProcess> ProcessRegistry::findRetired(const std::string& name) const {
+    const NameStripe& ns = nameStripe(name);
+    std::shared_lock<std::shared_mutex> lock(ns.mutex);
+    auto it = ns.retired.find(name);
+    return (it != ns.retired.end()) ? it->second : nullptr;
+}
+
+std::shared_ptr<ProcessControlBlock> ProcessRegistry::findByPid(int pid) const {
+    const PidStripe& ps = pidStripe(pid);
+    std::shared_lock<std::shared_mutex> lock(ps.mutex);
+    auto it = ps.live.find(pid);
+    return (it != ps.live.end()) ? it->second : nullptr;
+}
+
+std::string ProcessRegistry::nameOf(int pid) const {
+    const PidStripe& ps = pidStripe(pid);
+    std::shared_lock<std::shared_mutex> lock(ps.mutex);
+    auto it = ps.names.find(pid);
+    return (it != ps.names.end()) ? it->second : std::string();
+}
+
+std::vector<std::shared_ptr<ProcessControlBlock>> ProcessRegistry::liveProcesses() const {
+    std::vector<std::shared_ptr<ProcessControlBlock>> out;
+    out.reserve(liveCount());
+    for (const PidStripe& ps : pidStripes) {
+        std::shared_lock<std::shared_mutex> lock(ps.mutex);
+        for (const auto& kv : ps.live) out.push_back(kv.second);
+    }
+    return out;
+}
@@ -0,0 +1,67 @@
+#ifndef CSOPESY_REGISTRY_H
+#define CSOPESY_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ProcessControlBlock;
+struct RetiredProcess;
+
+// Concurrent process registry indexed by PID and by name.
+// Both indexes are split into independently locked stripes so lookups from
+// monitoring commands only ever take a shared lock on a single stripe and
+// never contend with the scheduler's process_table_mutex (ready queue).
+class ProcessRegistry {
+public:
+    // Registers a live process (replaces any live entry with the same name)
+    void add(const std::shared_ptr<ProcessControlBlock>& pcb);
+    // Drops a process from the live indexes and records its summary by name
+    void retire(const std::shared_ptr<ProcessControlBlock>& pcb, std::shared_ptr<const RetiredProcess> record);
+
+    // Live lookup by name; nullptr if not running
+    std::shared_ptr<ProcessControlBlock> findByName(const std::string& name) const;
+    // Finished lookup by name (most recent process with that name); nullptr if unknown
+    std::shared_ptr<const RetiredProcess> findRetired(const std::string& name) const;
+    // Live lookup by PID; nullptr if not running
+    std::shared_ptr<ProcessControlBlock> findByPid(int pid) const;
+    // Name of any process (live or retired) ever registered, empty if unknown
+    std::string nameOf(int pid) const;
+
+    // Copy of all live processes (each stripe locked briefly, one at a time)
+    std::vector<std::shared_ptr<ProcessControlBlock>> liveProcesses() const;
+    size_t liveCount() const { return numLive.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t NUM_STRIPES = 64;
+
+    struct PidStripe {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<int, std::shared_ptr<ProcessControlBlock>> live;
+        std::unordered_map<int, std::string> names; // survives retirement
+    };
+
+    struct NameStripe {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<ProcessControlBlock>> live;
+        std::unordered_map<std::string, std::shared_ptr<const RetiredProcess>> retired;
+    };
+
+    PidStripe& pidStripe(int pid) { return pidStripes[static_cast<size_t>(pid) % NUM_STRIPES]; }
+    const PidStripe& pidStripe(int pid) const { return pidStripes[static_cast<size_t>(pid) % NUM_STRIPES]; }
+    NameStripe& nameStripe(const std::string& name) { return nameStripes[std::hash<std::string>{}(name) % NUM_STRIPES]; }
+    const NameStripe& nameStripe(const std::string& name) const { return nameStripes[std::hash<std::string>{}(name) % NUM_STRIPES]; }
+
+    std::array<PidStripe, NUM_STRIPES> pidStripes;
+    std::array<NameStripe, NUM_STRIPES> nameStripes;
+    std::atomic<size_t> numLive{0};
+};
+
+// Global process registry instance
+extern ProcessRegistry process_registry;
+
+#endif // CSOPESY_REGISTRY_H
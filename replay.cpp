@@ -0,0 +1,309 @@
+#include "replay.h"
+#include "admission.h"
+#include "globals.h"
+#include "parser.h"
+#include "process.h"
+#include "program_cache.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ---- replay ----
+
+struct ReplayReader {
+    std::ifstream in;
+    std::string path;
+    uint64_t startTick = 0;
+    int lineNumber = 0;
+    std::string nextLine;     // read, but its arrival is still beyond the lookahead
+    uint64_t nextTick = 0;
+    bool hasNext = false;
+    std::deque<std::pair<uint64_t, std::shared_ptr<ProcessControlBlock>>> prepared; // parsed, not yet arrived
+    size_t admitted = 0;
+    uint64_t lastTick = 0;    // tick of the latest arrival admitted
+    bool finished = false;
+    std::string error;
+};
+
+static std::mutex replay_mutex; // guards reader
+static std::unique_ptr<ReplayReader> reader;
+static std::atomic<bool> replay_running{false};
+static std::thread replay_thread;
+
+// Next whitespace-separated token of `line` starting at `pos`
+static std::string next_token(const std::string& line, size_t& pos) {
+    size_t start = line.find_first_not_of(" \t\r", pos);
+    if (start == std::string::npos) {
+        pos = line.size();
+        return "";
+    }
+    size_t end = line.find_first_of(" \t\r", start);
+    if (end == std::string::npos) end = line.size();
+    pos = end;
+    return line.substr(start, end - start);
+}
+
+static bool fail(ReplayReader& r, const std::string& message) {
+    r.error = r.path + ":" + std::to_string(r.lineNumber) + ": " + message;
+    r.finished = true;
+    return false;
+}
+
+// Reads lines up to the next arrival; false at end of file or on a bad tick
+static bool read_next(ReplayReader& r) {
+    std::string line;
+    while (std::getline(r.in, line)) {
+        r.lineNumber++;
+        size_t pos = 0;
+        std::string tickStr = next_token(line, pos);
+        if (tickStr.empty() || tickStr[0] == '#') continue;
+        uint64_t tick = 0;
+        for (char c : tickStr) {
+            if (c < '0' || c > '9') return fail(r, "expected an arrival tick, got '" + tickStr + "'");
+            tick = tick * 10 + static_cast<uint64_t>(c - '0');
+        }
+        if (tick < r.nextTick) return fail(r, "arrival ticks must not decrease");
+        r.nextTick = tick;
+        r.nextLine = line.substr(pos);
+        r.hasNext = true;
+        return true;
+    }
+    return false;
+}
+
+// Builds the process for the buffered line
+static std::shared_ptr<ProcessControlBlock> parse_arrival(ReplayReader& r) {
+    const std::string& line = r.nextLine;
+    size_t pos = 0;
+    std::string name = next_token(line, pos);
+    std::string memStr = next_token(line, pos);
+    int mem = 0;
+    if (name.empty() || !parse_integer(memStr, mem) || mem < static_cast<int>(MIN_MEMORY_SIZE) ||
+        mem > static_cast<int>(MAX_MEMORY_SIZE)) {
+        fail(r, "expected <name> <mem> with mem in " + std::to_string(MIN_MEMORY_SIZE) + "-" +
+                    std::to_string(MAX_MEMORY_SIZE));
+        return nullptr;
+    }
+
+    auto pcb = std::make_shared<ProcessControlBlock>();
+    // Flags, then everything else is the program
+    while (true) {
+        size_t flagPos = pos;
+        std::string flag = next_token(line, pos);
+        if (flag != "-p" && flag != "-n") {
+            pos = flagPos;
+            break;
+        }
+        int value = 0;
+        if (!parse_integer(next_token(line, pos), value)) {
+            fail(r, flag + " needs a number");
+            return nullptr;
+        }
+        if (flag == "-p") pcb->priority = std::max(0, std::min(value, NUM_PRIORITY_LEVELS - 1));
+        else pcb->nice = std::max(-20, std::min(value, 19));
+    }
+
+    pcb->process = std::make_unique<Process>();
+    pcb->process->pid = generate_pid();
+    pcb->process->name = name;
+    ParseError error;
+    auto program = compile_program(std::string_view(line).substr(std::min(pos, line.size())), error);
+    if (!program) {
+        fail(r, "invalid program: " + error.describe());
+        return nullptr;
+    }
+    pcb->setProgram(std::move(program));
+    pcb->process->memorySize = static_cast<size_t>(mem);
+    pcb->initializeMemory(pcb->process->memorySize);
+    return pcb;
+}
+
+void replay_advance(uint64_t now) {
+    std::vector<std::shared_ptr<ProcessControlBlock>> batch;
+    {
+        std::lock_guard<std::mutex> lock(replay_mutex);
+        if (!reader || reader->finished) return;
+        ReplayReader& r = *reader;
+        uint64_t t = now > r.startTick ? now - r.startTick : 0;
+
+        // Parse programs whose arrival is near; leave the rest of the file unread
+        while ((r.hasNext || read_next(r)) && r.nextTick <= t + REPLAY_LOOKAHEAD_TICKS) {
+            auto pcb = parse_arrival(r);
+            if (!pcb) break;
+            r.prepared.emplace_back(r.nextTick, std::move(pcb));
+            r.hasNext = false;
+        }
+        while (!r.prepared.empty() && r.prepared.front().first <= t) {
+            r.lastTick = r.prepared.front().first;
+            batch.push_back(std::move(r.prepared.front().second));
+            r.prepared.pop_front();
+        }
+        r.admitted += batch.size();
+        if (!r.hasNext && r.prepared.empty() && !r.in.good()) r.finished = true;
+    }
+    if (!batch.empty()) admit_processes(std::move(batch));
+}
+
+bool replay_start(const std::string& path, std::string& error) {
+    replay_stop();
+    auto r = std::make_unique<ReplayReader>();
+    r->in.open(path);
+    if (!r->in) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    r->path = path;
+    r->startTick = static_cast<uint64_t>(cpuCycles.load());
+    {
+        std::lock_guard<std::mutex> lock(replay_mutex);
+        reader = std::move(r);
+    }
+    if (virtual_time) return true; // the virtual-time loop calls replay_advance every tick
+
+    replay_running = true;
+    replay_thread = std::thread([]() {
+        while (replay_running && is_running && replay_active()) {
+            replay_advance(static_cast<uint64_t>(cpuCycles.load()));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            cpuCycles++;
+        }
+    });
+    return true;
+}
+
+void replay_stop() {
+    replay_running = false;
+    if (replay_thread.joinable()) replay_thread.join();
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    if (reader) reader->finished = true; // keeps its counts for format_replay_status
+}
+
+bool replay_active() {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    return reader && !reader->finished;
+}
+
+// ---- capture ----
+
+static std::atomic<bool> capture_enabled{false};
+static std::mutex capture_mutex; // guards everything below
+static std::ofstream capture_out;
+static std::string capture_path;
+static uint64_t capture_start_tick = 0;
+static uint64_t capture_last_tick = 0;
+static size_t captured = 0;
+
+// Appends `instructions` in screen -c syntax; `name` fills in the generated processes' greeting
+static void format_program(const std::vector<Instruction>& instructions, const std::string& name, std::string& out) {
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        const Instruction& in = instructions[i];
+        if (i > 0) out += "; ";
+        switch (in.type) {
+            case PRINT:
+                if (!in.arg1.empty()) {
+                    out += "PRINT " + in.arg1;
+                } else {
+                    // Generated processes print a fixed greeting plus, optionally, one variable
+                    out += "PRINT \"Hello world from " + name + "!";
+                    const std::string valueFrom = "Value from: ";
+                    if (in.arg2.compare(0, valueFrom.size(), valueFrom) == 0) {
+                        out += " " + valueFrom + "\" + " + in.arg2.substr(valueFrom.size());
+                    } else {
+                        out += (in.arg2.empty() ? "" : " " + in.arg2) + "\"";
+                    }
+                }
+                break;
+            case DECLARE:
+                out += "DECLARE " + in.arg1 + " " + std::to_string(in.val1);
+                break;
+            case ADD:
+            case SUBTRACT:
+                // Operands are variables; a missing one reads as 0 either way
+                out += (in.type == ADD ? "ADD " : "SUBTRACT ") + in.arg1 + " " + (in.arg2.empty() ? "0" : in.arg2) +
+                       " " + (in.arg3.empty() ? "0" : in.arg3);
+                break;
+            case SLEEP:
+                out += "SLEEP " + std::to_string(std::min<uint16_t>(in.val1, 255)); // SLEEP runs at most 255 ticks
+                break;
+            case FOR_LOOP:
+                out += "FOR " + std::to_string(in.val1) + " { ";
+                format_program(in.instrSet, name, out);
+                out += " }";
+                break;
+            case READ_MEM:
+                out += "READ " + in.arg1 + " " + in.arg2;
+                break;
+            case WRITE_MEM:
+                out += "WRITE " + in.arg1 + " " + in.arg2;
+                break;
+        }
+    }
+}
+
+bool capture_start(const std::string& path, std::string& error) {
+    capture_stop();
+    std::lock_guard<std::mutex> lock(capture_mutex);
+    capture_out.open(path, std::ios::trunc);
+    if (!capture_out) {
+        error = "Cannot write " + path;
+        return false;
+    }
+    capture_out << "# csopesy workload trace: <tick> <name> <mem> [-p <priority>] [-n <nice>] <instructions>\n";
+    capture_path = path;
+    capture_start_tick = static_cast<uint64_t>(cpuCycles.load());
+    capture_last_tick = 0;
+    captured = 0;
+    capture_enabled = true;
+    return true;
+}
+
+size_t capture_stop() {
+    capture_enabled = false;
+    std::lock_guard<std::mutex> lock(capture_mutex);
+    if (capture_out.is_open()) capture_out.close();
+    return captured;
+}
+
+void capture_process(const ProcessControlBlock& pcb) {
+    if (!capture_enabled.load(std::memory_order_relaxed)) return;
+    std::string line = pcb.process->name + " " + std::to_string(pcb.process->memorySize);
+    if (pcb.priority != DEFAULT_PRIORITY) line += " -p " + std::to_string(pcb.priority);
+    if (pcb.nice != 0) line += " -n " + std::to_string(pcb.nice);
+    line += " ";
+    format_program(pcb.sourceProgram(), pcb.process->name, line);
+
+    std::lock_guard<std::mutex> lock(capture_mutex);
+    if (!capture_out.is_open()) return;
+    // Concurrent submitters may finish out of order; ticks in the file never go back
+    uint64_t now = static_cast<uint64_t>(cpuCycles.load()) - capture_start_tick;
+    capture_last_tick = std::max(capture_last_tick, now);
+    capture_out << capture_last_tick << " " << line << "\n";
+    captured++;
+}
+
+std::string format_replay_status() {
+    std::string out;
+    {
+        std::lock_guard<std::mutex> lock(replay_mutex);
+        if (reader) {
+            out += "Replay: " + reader->path + ", " + std::to_string(reader->admitted) + " processes admitted";
+            if (!reader->error.empty()) out += ", stopped: " + reader->error;
+            else if (reader->finished) out += ", finished";
+            else out += ", last arrival at tick " + std::to_string(reader->lastTick);
+            out += "\n";
+        }
+    }
+    std::lock_guard<std::mutex> lock(capture_mutex);
+    if (capture_out.is_open()) {
+        out += "Capture: " + capture_path + ", " + std::to_string(captured) + " processes\n";
+    }
+    return out;
+}
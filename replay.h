@@ -0,0 +1,37 @@
+#ifndef CSOPESY_REPLAY_H
+#define CSOPESY_REPLAY_H
+
+#include <cstdint>
+#include <string>
+
+struct ProcessControlBlock;
+
+// Workload traces: one process per line, in arrival order,
+//   <tick> <name> <mem> [-p <priority>] [-n <nice>] <instructions>
+// where <tick> counts from the start of the capture/replay and
+// <instructions> is screen -c syntax.
+// Lines starting with '#' are comments.
+//
+// Replay streams the file: lines are read and parsed only once their arrival
+// is within REPLAY_LOOKAHEAD_TICKS, so a trace never has to fit in memory.
+constexpr uint64_t REPLAY_LOOKAHEAD_TICKS = 64;
+
+// Starts replaying `path`. In virtual-time mode the virtual loop drives it
+// through replay_advance; otherwise a replay thread paces it like scheduler-test.
+bool replay_start(const std::string& path, std::string& error);
+void replay_stop();
+bool replay_active();
+// Admits every arrival due by `now` (cpuCycles)
+void replay_advance(uint64_t now);
+
+// Records every process submitted from now on to `path`
+bool capture_start(const std::string& path, std::string& error);
+// Closes the capture file; returns the number of processes written
+size_t capture_stop();
+// Appends `pcb` to the capture (no-op unless capturing)
+void capture_process(const ProcessControlBlock& pcb);
+
+// Replay and capture progress for vmstat ("" when neither is in use)
+std::string format_replay_status();
+
+#endif // CSOPESY_REPLAY_H
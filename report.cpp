@@ -0,0 +1,186 @@
+#include "report.h"
+#include "globals.h"
+#include "utils.h"
+#include "process.h"
+#include "archive.h"
+#include "snapshot.h"
+#include "display.h"
+#include "metrics.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+// Everything the writer needs, captured while the scheduler keeps running
+struct RunningRow {
+    std::string name;
+    std::string arrivalTime;
+    int core;
+    int programCounter;
+    int totalLines;
+};
+
+struct ReportJob {
+    std::string path;
+    bool incremental = false;
+    std::string timestamp;
+    int coresUsed = 0;
+    int numCpu = 1;
+    std::vector<RunningRow> running;
+    std::vector<std::shared_ptr<const RetiredProcess>> finished;
+    std::string timing; // per-scheduler response/waiting/turnaround summary
+};
+
+// Writer thread state
+static std::thread writer_thread;
+static std::mutex writer_mutex;
+static std::condition_variable writer_cv;
+static std::deque<ReportJob> pending_reports;
+static bool writer_stopping = false;
+
+// Finished processes already reported (incremental reports start after them).
+// Only request_report touches it, on the interpreter thread.
+static size_t report_watermark = 0;
+
+// Output is formatted into this much memory before each write() call
+static const size_t REPORT_CHUNK_SIZE = 1 << 20;
+
+static void append_finished_row(std::string& out, const RetiredProcess& f) {
+    out += f.name;
+    out += "    ";
+    out += f.finishTime;
+    out += "    Finished    ";
+    out += std::to_string(f.instructionsExecuted);
+    out += " / ";
+    out += std::to_string(f.totalInstructions);
+    // Scheduling times in CPU ticks; response and turnaround only once they exist
+    if (f.arrived) {
+        out += "    arrival " + std::to_string(f.arrivalTick);
+        if (f.hasRun) out += "  response " + std::to_string(f.responseTicks());
+        out += "  waiting " + std::to_string(f.waitingTicks);
+        if (f.completed) out += "  turnaround " + std::to_string(f.turnaroundTicks());
+    }
+    out += '\n';
+}
+
+static bool write_report(const ReportJob& job) {
+    std::ofstream ofs(job.path, job.incremental ? (std::ios::binary | std::ios::app)
+                                                : (std::ios::binary | std::ios::trunc));
+    if (!ofs) return false;
+
+    std::string chunk;
+    chunk.reserve(REPORT_CHUNK_SIZE + 256);
+    auto flush_if_full = [&]() {
+        if (chunk.size() >= REPORT_CHUNK_SIZE) {
+            ofs.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            chunk.clear();
+        }
+    };
+
+    if (job.incremental) {
+        chunk += "\n--- Incremental report " + job.timestamp + " ---\n";
+        chunk += "Finished since last report: " + std::to_string(job.finished.size()) + "\n";
+    } else {
+        chunk += "CPU utilization: " + std::to_string(job.coresUsed * 100 / std::max(1, job.numCpu)) + "%\n";
+        chunk += "Cores used: " + std::to_string(job.coresUsed) + "\n";
+        chunk += "Cores available: " + std::to_string(job.numCpu - job.coresUsed) + "\n\n";
+        chunk += "Running processes:\n";
+        for (const auto& row : job.running) {
+            chunk += row.name;
+            chunk += "    ";
+            chunk += row.arrivalTime;
+            chunk += "    Core: " + (row.core >= 0 ? std::to_string(row.core) : std::string("-")) + "    ";
+            chunk += std::to_string(row.programCounter) + " / " + std::to_string(row.totalLines) + "\n";
+            flush_if_full();
+        }
+        chunk += "\nFinished processes:\n";
+    }
+
+    for (const auto& f : job.finished) {
+        append_finished_row(chunk, *f);
+        flush_if_full();
+    }
+
+    if (!job.incremental) {
+        chunk += "\n";
+        chunk += job.timing;
+    }
+
+    ofs.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    return static_cast<bool>(ofs);
+}
+
+static void report_writer_loop() {
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    while (true) {
+        writer_cv.wait(lock, [] { return writer_stopping || !pending_reports.empty(); });
+        if (pending_reports.empty()) break; // stopping and drained
+        ReportJob job = std::move(pending_reports.front());
+        pending_reports.pop_front();
+        lock.unlock();
+
+        bool ok = write_report(job);
+        std::string status = ok ? "Report generated at " + job.path + " (" + std::to_string(job.finished.size()) +
+                                      (job.incremental ? " newly finished)" : " finished)")
+                                : "Failed to write report file.";
+        {
+            // Only replace our own "in progress" message, never a newer command's output
+            std::unique_lock<std::mutex> plock(prompt_mutex);
+            if (prompt_display_buffer.rfind("Generating report", 0) == 0) prompt_display_buffer = status;
+        }
+        notify_display();
+
+        lock.lock();
+    }
+}
+
+void request_report(bool incremental, const std::string& path) {
+    auto snap = latest_snapshot();
+    ReportJob job;
+    job.path = path;
+    job.incremental = incremental;
+    job.timestamp = snap->timestamp;
+    job.coresUsed = snap->coresUsed;
+    job.numCpu = snap->numCpu;
+    if (!incremental) job.timing = format_process_timing();
+
+    if (!incremental) {
+        for (auto& view : snap->running) {
+            job.running.push_back({view.name, view.arrivalTime, view.core, view.programCounter, view.totalLines});
+        }
+    }
+
+    // Finished rows come from the snapshot too, so the scheduler lock is never taken here
+    job.finished = finished_records(*snap, incremental ? std::min(report_watermark, snap->finishedCount) : 0);
+    report_watermark = snap->finishedCount;
+
+    std::string status = "Generating report at " + path + " (" + std::to_string(job.running.size()) +
+                         " running, " + std::to_string(job.finished.size()) +
+                         (incremental ? " newly finished)..." : " finished)...");
+    {
+        // Set before queueing so the writer's completion message always wins
+        std::unique_lock<std::mutex> lock(prompt_mutex);
+        prompt_display_buffer = status;
+    }
+    {
+        std::unique_lock<std::mutex> lock(writer_mutex);
+        if (!writer_thread.joinable()) {
+            writer_stopping = false;
+            writer_thread = std::thread(report_writer_loop);
+        }
+        pending_reports.push_back(std::move(job));
+    }
+    writer_cv.notify_one();
+}
+
+void shutdown_report_writer() {
+    {
+        std::unique_lock<std::mutex> lock(writer_mutex);
+        writer_stopping = true;
+    }
+    writer_cv.notify_one();
+    if (writer_thread.joinable()) writer_thread.join();
+}
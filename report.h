@@ -0,0 +1,14 @@
+#ifndef CSOPESY_REPORT_H
+#define CSOPESY_REPORT_H
+
+#include <string>
+
+// Takes a snapshot of the process lists and hands it to the background
+// report writer; progress and completion are shown in the prompt.
+// incremental = append only the processes finished since the last report.
+void request_report(bool incremental, const std::string& path = "csopesy-log.txt");
+
+// Waits for queued reports to be written and stops the writer thread
+void shutdown_report_writer();
+
+#endif // CSOPESY_REPORT_H
@@ -0,0 +1,56 @@
+#include "rng.h"
+
+#include <atomic>
+
+static std::atomic<uint64_t> active_seed{0};
+static std::atomic<uint64_t> seed_generation{1};
+static std::atomic<uint32_t> next_private_stream{1000}; // well clear of the named streams
+
+namespace {
+struct ThreadRng {
+    std::mt19937 engine;
+    uint64_t generation = 0; // seed generation the engine was seeded for
+    uint32_t stream = 0;
+    bool bound = false;
+};
+thread_local ThreadRng thread_state;
+}
+
+uint64_t seed_random(uint64_t seed) {
+    if (seed == 0) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+        if (seed == 0) seed = 1;
+    }
+    active_seed = seed;
+    seed_generation++;
+    return seed;
+}
+
+uint64_t current_seed() {
+    return active_seed.load();
+}
+
+void rng_bind_stream(uint32_t stream) {
+    thread_state.stream = stream;
+    thread_state.bound = true;
+    thread_state.generation = 0; // re-seed on next use
+}
+
+std::mt19937& thread_rng() {
+    ThreadRng& t = thread_state;
+    uint64_t generation = seed_generation.load();
+    if (t.generation != generation) {
+        if (!t.bound) {
+            t.stream = next_private_stream++;
+            t.bound = true;
+        }
+        if (active_seed.load() == 0) seed_random(0);
+        uint64_t seed = active_seed.load();
+        // Independent, reproducible stream per (seed, stream) pair
+        std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), t.stream};
+        t.engine.seed(seq);
+        t.generation = seed_generation.load();
+    }
+    return t.engine;
+}
@@ -0,0 +1,25 @@
+#ifndef CSOPESY_RNG_H
+#define CSOPESY_RNG_H
+
+#include <cstdint>
+#include <random>
+
+// Fixed streams for the threads whose random choices must replay exactly
+enum RngStream : uint32_t {
+    RNG_STREAM_GENERATOR = 0,   // scheduler-test process generator / virtual-time loop
+    RNG_STREAM_INTERPRETER = 1, // screen -s
+    RNG_STREAM_GENERATOR_POOL = 1u << 31 // + PID: one stream per process built by the scheduler-test pool
+};
+
+// Seeds every stream from `seed`; 0 draws a fresh seed from std::random_device.
+// Returns the seed in use so a run can be reproduced with the `seed` config key.
+uint64_t seed_random(uint64_t seed);
+uint64_t current_seed();
+
+// Binds the calling thread to a numbered stream
+void rng_bind_stream(uint32_t stream);
+// The calling thread's engine, re-seeded lazily whenever seed_random is called.
+// Threads that never bind get a private stream of their own.
+std::mt19937& thread_rng();
+
+#endif // CSOPESY_RNG_H
@@ -2,6 +2,17 @@
 #include "process.h"
 #include "globals.h"
 #include "memory.h"
+#include "registry.h"
+#include "archive.h"
+#include "snapshot.h"
+#include "metrics.h"
+#include "trace.h"
+#include "rng.h"
+#include "tuner.h"
+#include "admission.h"
+#include "workload.h"
+#include "replay.h"
+#include <cstdio>
 #include <random>
 #include <memory>
 #include <string>
@@ -10,37 +21,74 @@
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 // Forward declaration
 Instruction generate_random_instruction(int currentDepth, std::vector<std::string> declared_vars);
 
 // Scheduler runtime state
 static std::vector<std::thread> core_threads;
-static std::thread generator_thread;
 static std::thread sleep_watcher_thread;
+static std::thread snapshot_thread;
+static std::thread virtual_time_thread;
+static std::atomic<bool> generator_enabled{false}; // scheduler-test in virtual-time mode
 static std::atomic<bool> scheduler_active{false};
+static std::atomic<int> online_cores{0}; // cores running now; 'cores add/remove' changes it live
+// Blocked processes waiting to wake. A process joins only in end_run, after its
+// core has let go of it, so the sleep watcher never touches a PCB a core still runs.
+static std::vector<std::shared_ptr<ProcessControlBlock>> sleepers;
+static std::mutex sleepers_mutex;
+
+// Core count and throughput counters at each 'cores' change (interpreter thread only)
+struct CorePhase {
+    int cores;
+    std::chrono::steady_clock::time_point start;
+    uint64_t instructions;
+};
+static std::vector<CorePhase> core_phases;
+
+static bool core_online(int core) {
+    return core < online_cores.load(std::memory_order_relaxed);
+}
+
+int online_core_count() {
+    return scheduler_active ? online_cores.load() : num_cpu;
+}
 
 bool is_scheduler_active() {
     return scheduler_active;
 }
 
+std::shared_ptr<ProcessControlBlock> build_random_process(int pid, const std::string& name, size_t memorySize);
+
 std::shared_ptr<ProcessControlBlock> generate_random_process(size_t memorySize) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    return build_random_process(generate_pid(), generate_process_name(), memorySize);
+}
+
+// Draws the program from the calling thread's random stream
+std::shared_ptr<ProcessControlBlock> build_random_process(int pid, const std::string& name, size_t memorySize) {
+    std::mt19937& gen = thread_rng();
     
     std::uniform_int_distribution<> instruction_distrib(min_ins, max_ins);
     std::uniform_int_distribution<> add_value_distrib(1, 10);
     
     auto pcb = std::make_shared<ProcessControlBlock>();
     pcb->process = std::make_unique<Process>();
-    pcb->process->pid = generate_pid();
-    pcb->process->name = generate_process_name();
+    pcb->process->pid = pid;
+    pcb->process->name = name;
     pcb->process->memorySize = memorySize;
     pcb->processState = State::READY;
+    pcb->priority = std::uniform_int_distribution<>(0, NUM_PRIORITY_LEVELS - 1)(gen);
+    pcb->nice = std::uniform_int_distribution<>(-5, 5)(gen);
     
     // Initialize process memory buffer
     pcb->initializeMemory(memorySize);
 
+    if (auto profile = active_workload()) {
+        generate_workload_instructions(*profile, memorySize, pcb->process->instructions);
+        return pcb;
+    }
+
     // Initialize variable x to 0
     pcb->memory["x"] = 0;
 
@@ -90,8 +138,7 @@ std::shared_ptr<ProcessControlBlock> generate_random_process(size_t memorySize)
 }
 
 Instruction generate_random_instruction(int currentDepth, std::vector<std::string> declared_vars) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937& gen = thread_rng();
 
     std::uniform_int_distribution<> uint16_distrib(0, 65535);
     std::uniform_int_distribution<> uint8_distrib(0, 255);
@@ -155,142 +202,475 @@ Instruction generate_random_instruction(int currentDepth, std::vector<std::strin
     return instruction;
 }
 
+// Dispatch bookkeeping shared by the threaded cores and the virtual-time loop.
+// Returns true if the process last ran on another core (it pays migration-cost).
+static bool begin_run(ProcessControlBlock& pcb, int core, int& last_pid, uint64_t now) {
+    dispatch_count++;
+    trace_event(TraceEventType::Dispatch, pcb.process->pid);
+    bool migrated = pcb.lastCore >= 0 && pcb.lastCore != core;
+    if (core >= 0 && core < MAX_SCHEDULER_CORES) {
+        core_dispatches[core]++;
+        if (migrated) core_migrations[core]++;
+    }
+    if (migrated) {
+        migrations++;
+        pcb.migrations++;
+    }
+    pcb.lastCore = core;
+    pcb.publishedCore.store(core, std::memory_order_relaxed);
+    if (pcb.process->pid != last_pid) {
+        context_switches++;
+        last_pid = pcb.process->pid;
+    }
+    if (!pcb.hasRun) {
+        pcb.hasRun = true;
+        pcb.firstRunTick = now;
+    }
+    pcb.quantaRun++;
+    return migrated;
+}
+
+// Instructions a process may run per dispatch; -1 runs until it blocks or finishes
+static int time_slice(const ProcessControlBlock& pcb) {
+    switch (scheduler_policy) {
+        case SchedulerPolicy::RR:
+        case SchedulerPolicy::Priority:
+            return current_quantum.load(std::memory_order_relaxed);
+        case SchedulerPolicy::MLFQ: {
+            // Configured quanta, then doubling per level below the last one given
+            int slice = current_quantum.load(std::memory_order_relaxed);
+            for (int level = 0; level <= pcb.mlfqLevel; ++level) {
+                if (level < static_cast<int>(mlfq_quanta.size())) slice = std::max(1, mlfq_quanta[level]);
+                else if (level > 0) slice *= 2;
+            }
+            return slice;
+        }
+        case SchedulerPolicy::CFS:
+            return std::max(1, pcb.timeSlice);  // picked by the ready queue at dispatch
+        case SchedulerPolicy::EDF:
+            // Real-time jobs run until done or an earlier deadline preempts; best effort is RR
+            return pcb.rtPeriod > 0 ? -1 : current_quantum.load(std::memory_order_relaxed);
+        default:
+            return -1;
+    }
+}
+
+// Takes a process off its core: retire it, leave it asleep, or requeue it
+static void end_run(int core, const std::shared_ptr<ProcessControlBlock>& pcb, ProcessTimingStats& timing,
+                    uint64_t run_start, uint64_t run_end, int executed) {
+    bool preempted = ready_queue.preemptRequested(core);
+    ready_queue.release(core);
+    uint64_t ran = run_end > run_start ? run_end - run_start : 0;
+    pcb->runTicks += ran;
+    timing.burst.record(ran);
+    // CFS: heavier (lower nice) processes accrue virtual runtime more slowly
+    if (executed > 0) {
+        pcb->vruntime += static_cast<uint64_t>(executed) * NICE_0_WEIGHT * NICE_0_WEIGHT / nice_to_weight(pcb->nice);
+    }
+    pcb->publishedVruntime.store(pcb->vruntime, std::memory_order_relaxed);
+    pcb->publishedRunTicks.store(pcb->runTicks, std::memory_order_relaxed);
+
+    // A finished real-time job: account its deadline, then restart the program
+    // for the next job (right away if its release has already passed)
+    if (pcb->processState == State::TERMINATED && pcb->rtPeriod > 0) {
+        uint64_t deadline = pcb->rtAbsoluteDeadline();
+        uint64_t lateness = run_end > deadline ? run_end - deadline : 0;
+        record_deadline(timing, lateness);
+        if (lateness > 0) pcb->deadlineMisses++;
+        pcb->maxLateness = std::max(pcb->maxLateness, lateness);
+        pcb->rtJobsDone++;
+        pcb->publishedJobsDone.store(pcb->rtJobsDone, std::memory_order_relaxed);
+        pcb->publishedDeadlineMisses.store(pcb->deadlineMisses, std::memory_order_relaxed);
+        pcb->publishedMaxLateness.store(pcb->maxLateness, std::memory_order_relaxed);
+        if (pcb->rtJobsDone < pcb->rtJobs && !pcb->hasMemoryViolation) {
+            pcb->programCounter = 0;
+            pcb->publishProgress();
+            pcb->rtAwaitingRelease = run_end < pcb->rtJobRelease();
+            pcb->processState = pcb->rtAwaitingRelease ? State::BLOCKED : State::READY;
+        }
+    }
+
+    if (pcb->processState == State::TERMINATED) {
+        trace_event(TraceEventType::Terminate, pcb->process->pid);
+        pcb->finishTick = run_end;
+        record_process_timing(scheduler_policy_name(scheduler_policy), *pcb);
+        // Deallocate memory for terminated process
+        if (globalMemory) {
+            globalMemory->deallocateProcess(pcb->process->pid);
+        }
+
+        // Keep only a summary; the PCB (program, logs, memory image) is released here
+        auto record = process_archive.retire(*pcb);
+        process_registry.retire(pcb, record);
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        finished_processes.push_back(record);
+    } else if (pcb->processState == State::BLOCKED) {
+        trace_event(TraceEventType::Sleep, pcb->process->pid, pcb->sleepTicks);
+        if (!pcb->rtAwaitingRelease) quantum_tuner_record_sleep_burst(executed);
+        std::lock_guard<std::mutex> lock(sleepers_mutex);
+        sleepers.push_back(pcb);
+    } else if (pcb->processState == State::READY) {
+        trace_event(TraceEventType::Preempt, pcb->process->pid);
+        // MLFQ: using the whole quantum means CPU-bound, move down a level.
+        // Blocking on SLEEP (handled above) keeps the level.
+        if (scheduler_policy == SchedulerPolicy::MLFQ && !preempted && executed >= time_slice(*pcb)) {
+            pcb->mlfqLevel = std::min(pcb->mlfqLevel + 1, std::max(1, mlfq_levels) - 1);
+        }
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        ready_queue.push(pcb, preempted);
+        ready_cv.notify_one();
+    }
+}
+
+// EDF admission control: the process's utilization plus that of every live
+// real-time process must not exceed num-cpu. This is the necessary condition
+// for global EDF on num-cpu cores; heavy task sets can still miss deadlines.
+bool edf_admit(const ProcessControlBlock& pcb, std::string& error) {
+    double total = pcb.rtUtilization();
+    for (auto& live : process_registry.liveProcesses()) total += live->rtUtilization();
+    int cores = std::max(1, online_core_count());
+    if (total > static_cast<double>(cores)) {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "rejected: real-time utilization would be %.2f (limit %d cores)", total, cores);
+        error = buf;
+        return false;
+    }
+    return true;
+}
+
+// Generates one scheduler-test process and admits it (or queues it until memory frees up)
+static void admit_generated_process() {
+    admit_processes({generate_random_process(generated_process_memory())});
+}
+
+// Counts down sleeping processes; returns those that woke up this tick (in PID order)
+static std::vector<std::shared_ptr<ProcessControlBlock>> tick_sleepers() {
+    std::vector<std::shared_ptr<ProcessControlBlock>> woken;
+    uint64_t now = static_cast<uint64_t>(cpuCycles.load());
+    {
+        std::lock_guard<std::mutex> lock(sleepers_mutex);
+        // Every PCB here is off its core, so its state is ours to change
+        auto still_asleep = std::remove_if(sleepers.begin(), sleepers.end(), [&](const auto& pcb) {
+            if (pcb->rtAwaitingRelease) {
+                if (now < pcb->rtJobRelease()) return false;
+                pcb->rtAwaitingRelease = false;
+            } else if (pcb->sleepTicks > 0 && --pcb->sleepTicks > 0) {
+                return false;
+            }
+            pcb->processState = State::READY;
+            trace_event(TraceEventType::Wake, pcb->process->pid);
+            woken.push_back(pcb);
+            return true;
+        });
+        sleepers.erase(still_asleep, sleepers.end());
+    }
+    std::sort(woken.begin(), woken.end(), [](const auto& a, const auto& b) { return a->process->pid < b->process->pid; });
+    return woken;
+}
+
+// Deterministic mode: one thread steps generator, sleepers and every core in
+// lockstep, one instruction per core per tick. Given the same seed and config,
+// arrivals and scheduling decisions replay exactly regardless of host timing.
+static void virtual_time_loop() {
+    struct VirtualCore {
+        std::shared_ptr<ProcessControlBlock> pcb;
+        int quantumLeft = 0;
+        int executed = 0;
+        int stall = 0;          // migration-cost ticks left before the process runs
+        uint64_t runStart = 0;
+        int lastPid = -1;
+    };
+    rng_bind_stream(RNG_STREAM_GENERATOR);
+    std::vector<VirtualCore> cores(static_cast<size_t>(online_cores.load()));
+    ProcessTimingStats& timing = process_timing(scheduler_policy_name(scheduler_policy));
+    uint64_t tick = 0;
+
+    while (scheduler_active && is_running) {
+        // Unplugged cores hand their process back to the ready queue, state intact
+        size_t online = static_cast<size_t>(online_cores.load());
+        for (size_t c = online; c < cores.size(); ++c) {
+            if (!cores[c].pcb) continue;
+            active_cores--;
+            end_run(static_cast<int>(c), cores[c].pcb, timing, cores[c].runStart, tick, cores[c].executed);
+        }
+        cores.resize(online);
+
+        if (replay_active()) replay_advance(static_cast<uint64_t>(cpuCycles.load()));
+        // Arrivals pause while the admission backlog is full
+        if (generator_enabled && tick % static_cast<uint64_t>(std::max(1, batch_process_freq)) == 0 &&
+            pending_admissions() < MAX_PENDING_ADMISSIONS) {
+            admit_generated_process();
+        } else if (pending_admissions() > 0) {
+            admit_processes({}); // retry whatever is waiting for memory
+        }
+
+        trace_bind_thread(TRACE_WATCHER_LANE);
+        auto woken = tick_sleepers();
+        if (!woken.empty()) {
+            std::unique_lock<std::mutex> lock(process_table_mutex);
+            for (auto &pcb : woken) ready_queue.push(pcb);
+        }
+        quantum_tuner_tick(static_cast<uint64_t>(cpuCycles.load()), static_cast<int>(cores.size()));
+
+        for (int c = 0; c < static_cast<int>(cores.size()); ++c) {
+            VirtualCore& core = cores[c];
+            trace_bind_thread(c);
+            if (!core.pcb) {
+                {
+                    std::unique_lock<std::mutex> lock(process_table_mutex);
+                    core.pcb = ready_queue.pop(c);
+                }
+                if (!core.pcb) {
+                    if (globalMemory) globalMemory->updateCpuTicks(true);
+                    continue;
+                }
+                bool migrated = begin_run(*core.pcb, c, core.lastPid, tick);
+                core.stall = migrated ? std::max(0, migration_cost) : 0;
+                core.quantumLeft = time_slice(*core.pcb);
+                core.executed = 0;
+                core.runStart = tick;
+                active_cores++;
+            }
+
+            if (globalMemory) globalMemory->updateCpuTicks(false);
+            if (core.stall > 0) {
+                core.stall--;
+                continue;
+            }
+            execute_instruction(*core.pcb, c);
+            core.pcb->publishProgress();
+            if (scheduler_policy == SchedulerPolicy::SRTF) ready_queue.updateRunning(c, *core.pcb);
+            instructions_executed++;
+            core.executed++;
+            if (core.quantumLeft > 0) core.quantumLeft--;
+
+            if (core.pcb->processState == State::BLOCKED || core.pcb->processState == State::TERMINATED ||
+                core.quantumLeft == 0 || ready_queue.preemptRequested(c)) {
+                active_cores--;
+                end_run(c, core.pcb, timing, core.runStart, tick + 1, core.executed);
+                core.pcb.reset();
+            }
+        }
+
+        tick++;
+        cpuCycles++;
+        // Pacing only; nothing above depends on how long this takes
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::max(1, delay_per_exec)));
+    }
+
+    // Hand unfinished work back so scheduler_stop can retire it
+    std::unique_lock<std::mutex> lock(process_table_mutex);
+    for (int c = 0; c < static_cast<int>(cores.size()); ++c) {
+        if (cores[c].pcb) {
+            active_cores--;
+            ready_queue.release(c);
+            ready_queue.push(cores[c].pcb);
+        }
+    }
+}
+
+// One core worker thread; exits when the scheduler stops or the core is removed
+static void core_loop(int core) {
+    trace_bind_thread(core);
+    int last_pid = -1; // process this core ran last (context-switch accounting)
+    ProcessTimingStats& timing = process_timing(scheduler_policy_name(scheduler_policy));
+    while (scheduler_active && is_running && core_online(core)) {
+        std::shared_ptr<ProcessControlBlock> pcb;
+        {
+            // Lock stalls are only timed while tracing
+            bool tracing = tracing_enabled.load(std::memory_order_relaxed);
+            uint64_t lock_start = tracing ? trace_now_ns() : 0;
+            std::unique_lock<std::mutex> lock(process_table_mutex);
+            if (tracing) {
+                uint64_t waited = trace_now_ns() - lock_start;
+                if (waited >= TRACE_LOCK_WAIT_NS) trace_event(TraceEventType::LockWait, -1, waited);
+            }
+            if (ready_queue.empty()) {
+                ready_cv.wait_for(lock, std::chrono::milliseconds(10));
+                if (ready_queue.empty()) {
+                    // Track idle CPU tick when no process to run
+                    if (globalMemory) globalMemory->updateCpuTicks(true);
+                    continue;
+                }
+            }
+            pcb = ready_queue.pop(core);
+        }
+        if (!pcb) continue;
+
+        uint64_t run_start = static_cast<uint64_t>(cpuCycles.load());
+        bool migrated = begin_run(*pcb, core, last_pid, run_start);
+
+        active_cores++; // Mark core as active
+        if (globalMemory) globalMemory->updateCpuTicks(false); // Track active CPU tick
+
+        // A migrated process starts cold: the core spends migration-cost ticks before it runs
+        for (int i = 0; migrated && i < migration_cost && scheduler_active && is_running; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::max(1, delay_per_exec)));
+            cpuCycles++;
+        }
+
+        // Run until the slice is used up (-1: no limit), the process blocks or
+        // finishes, a more urgent arrival asks this core to preempt, or the core
+        // is unplugged (the process goes back to the ready queue intact). A
+        // preemption takes effect after the first instruction, so every dispatch
+        // makes progress, as in virtual-time mode.
+        int slice = time_slice(*pcb);
+        int q = 0;
+        for (; (slice < 0 || q < slice) && pcb->processState != State::BLOCKED &&
+                        pcb->processState != State::TERMINATED && scheduler_active && is_running &&
+                        core_online(core) && (q == 0 || !ready_queue.preemptRequested(core)); ++q) {
+            execute_instruction(*pcb, core);
+            pcb->publishProgress();
+            if (scheduler_policy == SchedulerPolicy::SRTF) ready_queue.updateRunning(core, *pcb);
+            if (delay_per_exec > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay_per_exec));
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            cpuCycles++;
+            instructions_executed++;
+        }
+
+        active_cores--; // Mark core as idle
+        if (globalMemory) globalMemory->updateCpuTicks(true); // Track idle CPU tick
+        end_run(core, pcb, timing, run_start, static_cast<uint64_t>(cpuCycles.load()), q);
+    }
+}
+
 void scheduler_start() {
     if (scheduler_active) return;
     scheduler_active = true;
     scheduler_running = true;
+    {
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        ready_queue.configure(scheduler_policy, num_cpu, aging_cycles);
+        ready_queue.configureLevels(mlfq_levels, mlfq_boost_cycles);
+        ready_queue.configureFair(cfs_target_latency, cfs_min_granularity);
+        ready_queue.configureAffinity(affinity_window);
+    }
+    quantum_tuner_reset();
+
+    online_cores = std::max(1, std::min(num_cpu, MAX_SCHEDULER_CORES));
+    core_phases.assign(1, {online_cores.load(), std::chrono::steady_clock::now(), instructions_executed.load()});
+
+    // Snapshot publisher: monitoring commands read this instead of live PCBs
+    snapshot_thread = std::thread([](){
+        while (scheduler_active && is_running) {
+            publish_snapshot();
+            std::this_thread::sleep_for(std::chrono::milliseconds(SNAPSHOT_INTERVAL_MS));
+        }
+    });
+
+    if (virtual_time) {
+        virtual_time_thread = std::thread(virtual_time_loop);
+        return;
+    }
 
     // Sleep watcher thread
     sleep_watcher_thread = std::thread([](){
+        trace_bind_thread(TRACE_WATCHER_LANE);
         while (scheduler_active && is_running) {
-            {
+            // Walk the registry without holding the ready-queue lock, then
+            // requeue everything that woke up in one critical section
+            auto woken = tick_sleepers();
+            if (!woken.empty()) {
                 std::unique_lock<std::mutex> lock(process_table_mutex);
-                for (auto &kv : process_table) {
-                    auto &pcb = kv.second;
-                    if (!pcb) continue;
-                    if (pcb->processState == State::BLOCKED && pcb->sleepTicks > 0) {
-                        pcb->sleepTicks--;
-                        if (pcb->sleepTicks == 0) {
-                            pcb->processState = State::READY;
-                            ready_queue.push(pcb);
-                            ready_cv.notify_one();
-                        }
-                    }
-                }
+                for (auto &pcb : woken) ready_queue.push(pcb);
+                ready_cv.notify_all();
             }
+            quantum_tuner_tick(static_cast<uint64_t>(cpuCycles.load()), online_cores.load());
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     });
 
+    preparation_pool_start(prepare_threads);
+
     // Core worker threads
     core_threads.clear();
-    for (int core = 0; core < std::max(1, num_cpu); ++core) {
-        core_threads.emplace_back([core](){
-            while (scheduler_active && is_running) {
-                std::shared_ptr<ProcessControlBlock> pcb;
-                {
-                    std::unique_lock<std::mutex> lock(process_table_mutex);
-                    if (ready_queue.empty()) {
-                        ready_cv.wait_for(lock, std::chrono::milliseconds(10));
-                        if (ready_queue.empty()) {
-                            // Track idle CPU tick when no process to run
-                            if (globalMemory) globalMemory->updateCpuTicks(true);
-                            continue;
-                        }
-                    }
-                    if (!ready_queue.empty()) {
-                        pcb = ready_queue.front();
-                        ready_queue.pop();
-                    }
-                }
-                if (!pcb) continue;
-
-                active_cores++; // Mark core as active
-                if (globalMemory) globalMemory->updateCpuTicks(false); // Track active CPU tick
-
-                if (scheduler_type == "rr") {
-                    int quantum = std::max(1, quantum_cycles);
-                    for (int q = 0; q < quantum && pcb->processState != State::BLOCKED && pcb->processState != State::TERMINATED; ++q) {
-                        execute_instruction(*pcb, core);
-                        if (delay_per_exec > 0) {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(delay_per_exec));
-                        } else {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                        }
-                        cpuCycles++;
-                    }
-                } else { // FCFS
-                    while (pcb->processState != State::BLOCKED && pcb->processState != State::TERMINATED && scheduler_active && is_running) {
-                        execute_instruction(*pcb, core);
-                        if (delay_per_exec > 0) {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(delay_per_exec));
-                        } else {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                        }
-                        cpuCycles++;
-                    }
-                }
+    for (int core = 0; core < online_cores; ++core) core_threads.emplace_back(core_loop, core);
+}
 
-                active_cores--; // Mark core as idle
-                if (globalMemory) globalMemory->updateCpuTicks(true); // Track idle CPU tick
+bool scheduler_set_cores(int count, std::string& message) {
+    if (count < 1 || count > MAX_SCHEDULER_CORES) {
+        message = "core count must be between 1 and " + std::to_string(MAX_SCHEDULER_CORES);
+        return false;
+    }
+    if (!scheduler_active) {
+        num_cpu = count;
+        message = "Scheduler not running; it will start with " + std::to_string(count) + " cores.";
+        return true;
+    }
 
-                if (pcb->processState == State::TERMINATED) {
-                    // Deallocate memory for terminated process
-                    if (globalMemory) {
-                        globalMemory->deallocateProcess(pcb->process->pid);
-                    }
-                    
-                    std::unique_lock<std::mutex> lock(process_table_mutex);
-                    finished_processes.push_back(pcb);
-                    process_table.erase(pcb->process->name);
-                } else if (pcb->processState == State::READY) {
-                    std::unique_lock<std::mutex> lock(process_table_mutex);
-                    ready_queue.push(pcb);
-                    ready_cv.notify_one();
-                }
+    int previous = online_cores.load();
+    if (count > previous) {
+        {
+            std::unique_lock<std::mutex> lock(process_table_mutex);
+            ready_queue.setCoreCount(count);
+        }
+        online_cores = count;
+        if (!virtual_time) {
+            if (static_cast<int>(core_threads.size()) < count) core_threads.resize(static_cast<size_t>(count));
+            for (int core = previous; core < count; ++core) {
+                // A core removed earlier may still be finishing its last instruction
+                if (core_threads[core].joinable()) core_threads[core].join();
+                core_threads[core] = std::thread(core_loop, core);
             }
-        });
+        }
+    } else if (count < previous) {
+        online_cores = count;
+        {
+            std::unique_lock<std::mutex> lock(process_table_mutex);
+            ready_queue.setCoreCount(count);
+        }
+        ready_cv.notify_all();
+        if (!virtual_time) {
+            // Each removed core requeues its process at the next instruction boundary
+            for (int core = count; core < previous && core < static_cast<int>(core_threads.size()); ++core) {
+                if (core_threads[core].joinable()) core_threads[core].join();
+            }
+        }
+    }
+
+    // Kept for the next scheduler-start too, until 'initialize' reloads num-cpu
+    num_cpu = count;
+    core_phases.push_back({count, std::chrono::steady_clock::now(), instructions_executed.load()});
+    message = "Cores online: " + std::to_string(previous) + " -> " + std::to_string(count);
+    return true;
+}
+
+std::string format_core_phases() {
+    std::ostringstream oss;
+    oss << "Cores online: " << online_core_count() << "\n";
+    if (!scheduler_active || core_phases.empty()) return oss.str();
+    oss << "Throughput per core count:\n";
+    auto now = std::chrono::steady_clock::now();
+    uint64_t instructionsNow = instructions_executed.load();
+    for (size_t i = 0; i < core_phases.size(); ++i) {
+        const CorePhase& phase = core_phases[i];
+        bool last = i + 1 == core_phases.size();
+        auto end = last ? now : core_phases[i + 1].start;
+        uint64_t endInstructions = last ? instructionsNow : core_phases[i + 1].instructions;
+        double seconds = std::chrono::duration<double>(end - phase.start).count();
+        uint64_t done = endInstructions > phase.instructions ? endInstructions - phase.instructions : 0;
+        oss << "  " << phase.cores << " cores  " << std::fixed << std::setprecision(1) << seconds << " s  "
+            << std::setprecision(0) << (seconds > 0 ? static_cast<double>(done) / seconds : 0.0)
+            << " instructions/s" << (last ? "  (current)" : "") << "\n";
     }
+    return oss.str();
 }
 
 void scheduler_test() {
     if (!scheduler_active) {
         scheduler_start();
     }
-    
-    if (generator_thread.joinable()) return;
-    
+
     scheduler_running = true;
-    
-    generator_thread = std::thread([](){
-        while (scheduler_running && is_running) {
-            // Use configured per-process memory from config (bytes)
-            size_t memLow = std::max<size_t>(64, min_mem_per_proc);
-            size_t memHigh = std::max(memLow, max_mem_per_proc);
-            size_t pmem = memHigh; // choose upper bound to stress paging
-            auto pcb = generate_random_process(pmem);
-            
-            // Allocate memory for the process
-            bool allocated = true;
-            if (globalMemory) {
-                allocated = globalMemory->allocateProcess(pcb->process->pid, pmem);
-            }
-            
-            if (allocated) {
-                {
-                    std::unique_lock<std::mutex> lock(process_table_mutex);
-                    process_table[pcb->process->name] = pcb;
-                    ready_queue.push(pcb);
-                }
-                ready_cv.notify_one();
-            }
+    if (virtual_time) {
+        generator_enabled = true; // the virtual-time loop admits processes on its own ticks
+        return;
+    }
 
-            for (int i = 0; i < std::max(1, batch_process_freq) && scheduler_running && is_running; ++i) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                cpuCycles++;
-            }
-        }
-    });
+    generator_pool_start(generator_threads);
 }
 
 void scheduler_stop() {
@@ -298,27 +678,37 @@ void scheduler_stop() {
     
     // Stop generator first (stops creating new processes)
     scheduler_running = false;
-    if (generator_thread.joinable()) generator_thread.join();
+    generator_enabled = false;
+    generator_pool_stop();
+    replay_stop();
+    preparation_pool_stop();
     
     // Stop scheduler cores immediately
     scheduler_active = false;
     ready_cv.notify_all();
 
     if (sleep_watcher_thread.joinable()) sleep_watcher_thread.join();
+    if (snapshot_thread.joinable()) snapshot_thread.join();
+    if (virtual_time_thread.joinable()) virtual_time_thread.join();
     for (auto &t : core_threads) if (t.joinable()) t.join();
     core_threads.clear();
+    {
+        std::lock_guard<std::mutex> lock(sleepers_mutex);
+        sleepers.clear(); // retired with the other live processes below
+    }
     
     // Move any remaining processes to finished WITHOUT deallocating memory
     // (preserves deadlock state for process-smi inspection)
     {
-        std::unique_lock<std::mutex> lock(process_table_mutex);
-        for (auto &kv : process_table) {
-            // Do NOT deallocate - keep processes in memory for inspection
-            finished_processes.push_back(kv.second);
-        }
-        process_table.clear();
-        while (!ready_queue.empty()) {
-            ready_queue.pop();
+        // Do NOT deallocate - keep page tables in memory for inspection
+        std::vector<std::shared_ptr<const RetiredProcess>> records;
+        for (auto &pcb : process_registry.liveProcesses()) {
+            records.push_back(process_archive.retire(*pcb));
+            process_registry.retire(pcb, records.back());
         }
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        finished_processes.insert(finished_processes.end(), records.begin(), records.end());
+        ready_queue.clear();
     }
+    clear_pending_admissions(); // never admitted, so never registered
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "snapshot.h"
+#include "globals.h"
+#include "utils.h"
+#include "process.h"
+#include "registry.h"
+#include "metrics.h"
+#include "admission.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+// Forward declarations from scheduler.cpp
+bool is_scheduler_active();
+int online_core_count();
+
+// Current snapshot; only ever accessed through std::atomic_load/atomic_store
+static std::shared_ptr<const SystemSnapshot> published_snapshot;
+static std::atomic<uint64_t> snapshot_version{0};
+// Finished-process history as of the last publish; guarded by history_mutex
+static std::shared_ptr<const FinishedSegment> finished_history;
+static std::mutex history_mutex;
+
+// Adds the processes that finished since the last publish to the history
+static std::shared_ptr<const FinishedSegment> update_finished_history() {
+    std::lock_guard<std::mutex> history_lock(history_mutex);
+    size_t known = finished_history ? finished_history->total : 0;
+    auto segment = std::make_shared<FinishedSegment>();
+    {
+        // Only the new pointers are copied under the scheduler lock
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        if (finished_processes.size() <= known) return finished_history;
+        segment->records.assign(finished_processes.begin() + static_cast<std::ptrdiff_t>(known),
+                                finished_processes.end());
+    }
+    auto previous = finished_history;
+    while (previous && previous->records.size() <= segment->records.size()) {
+        segment->records.insert(segment->records.begin(), previous->records.begin(), previous->records.end());
+        previous = previous->previous;
+    }
+    segment->previous = previous;
+    segment->total = (previous ? previous->total : 0) + segment->records.size();
+    finished_history = segment;
+    return finished_history;
+}
+
+std::shared_ptr<const SystemSnapshot> publish_snapshot() {
+    auto snap = std::make_shared<SystemSnapshot>();
+    snap->timestamp = get_timestamp();
+    snap->schedulerActive = is_scheduler_active();
+    snap->numCpu = online_core_count();
+    snap->coresUsed = snap->schedulerActive ? active_cores.load() : 0;
+
+    // Only the atomically published progress fields of each PCB are read here
+    auto live = process_registry.liveProcesses();
+    snap->running.reserve(live.size());
+    uint64_t now = static_cast<uint64_t>(cpuCycles.load());
+    std::vector<double> shares;
+    for (auto& pcb : live) {
+        ProcessView view;
+        view.name = pcb->process->name;
+        view.pid = pcb->process->pid;
+        view.arrivalTime = pcb->arrivalTime;
+        view.core = pcb->publishedCore.load(std::memory_order_relaxed);
+        pcb->readProgress(view.programCounter, view.totalLines);
+        if (view.totalLines == 0) view.totalLines = static_cast<int>(pcb->sourceProgram().size());
+        view.nice = pcb->nice;
+        if (pcb->rtPeriod > 0) {
+            view.realtime = true;
+            view.rtJobs = pcb->rtJobs;
+            view.rtJobsDone = pcb->publishedJobsDone.load(std::memory_order_relaxed);
+            view.deadlineMisses = pcb->publishedDeadlineMisses.load(std::memory_order_relaxed);
+            view.maxLateness = pcb->publishedMaxLateness.load(std::memory_order_relaxed);
+        }
+        view.vruntime = pcb->publishedVruntime.load(std::memory_order_relaxed) / NICE_0_WEIGHT;
+        if (now > pcb->arrivalTick) {
+            double weight = static_cast<double>(nice_to_weight(pcb->nice)) / NICE_0_WEIGHT;
+            double ran = static_cast<double>(pcb->publishedRunTicks.load(std::memory_order_relaxed));
+            view.cpuShare = ran / (static_cast<double>(now - pcb->arrivalTick) * weight);
+            shares.push_back(view.cpuShare);
+        }
+        snap->running.push_back(std::move(view));
+    }
+    snap->fairnessIndex = jain_fairness_index(shares);
+    snap->pendingAdmissions = pending_admissions();
+    snap->finished = update_finished_history();
+    snap->finishedCount = snap->finished ? snap->finished->total : 0;
+    {
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        snap->readyLevels = ready_queue.levelDepths();
+    }
+
+    if (globalMemory) {
+        snap->hasMemory = true;
+        snap->memory = globalMemory->getStats();
+        snap->processMemory = globalMemory->getAllProcessMemoryInfo();
+    }
+
+    snap->version = ++snapshot_version;
+    std::shared_ptr<const SystemSnapshot> result = std::move(snap);
+    std::atomic_store(&published_snapshot, result);
+    return result;
+}
+
+std::shared_ptr<const SystemSnapshot> latest_snapshot() {
+    auto snap = std::atomic_load(&published_snapshot);
+    if (!snap || !is_scheduler_active()) snap = publish_snapshot(); // nobody is publishing; build one now
+    return snap;
+}
+
+std::vector<std::shared_ptr<const RetiredProcess>> finished_records(const SystemSnapshot& snap, size_t from) {
+    std::vector<const FinishedSegment*> segments; // newest first
+    for (auto segment = snap.finished.get(); segment; segment = segment->previous.get()) segments.push_back(segment);
+    std::vector<std::shared_ptr<const RetiredProcess>> records;
+    records.reserve(snap.finishedCount > from ? snap.finishedCount - from : 0);
+    size_t index = 0;
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        const auto& part = (*it)->records;
+        if (index + part.size() > from) {
+            size_t skip = from > index ? from - index : 0;
+            records.insert(records.end(), part.begin() + static_cast<std::ptrdiff_t>(skip), part.end());
+        }
+        index += part.size();
+    }
+    return records;
+}
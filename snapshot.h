@@ -0,0 +1,73 @@
+#ifndef CSOPESY_SNAPSHOT_H
+#define CSOPESY_SNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "memory.h"
+
+// Point-in-time view of one live process
+struct ProcessView {
+    std::string name;
+    int pid = 0;
+    std::string arrivalTime;
+    int core = -1;           // core running it, or the one it last ran on (-1 = not yet run)
+    int programCounter = 0;
+    int totalLines = 0;
+    int nice = 0;
+    uint64_t vruntime = 0;   // CFS virtual runtime, in nice-0 instructions
+    double cpuShare = 0.0;   // cpu ticks received per tick alive, divided by the nice weight (nice 0 = 1)
+    bool realtime = false;   // EDF job accounting below
+    int rtJobs = 0;
+    int rtJobsDone = 0;
+    int deadlineMisses = 0;
+    uint64_t maxLateness = 0;
+};
+
+struct RetiredProcess;
+
+// Append-only history of finished processes, shared by successive snapshots.
+// Each publish adds one segment with the processes that finished since the
+// last; a segment absorbs earlier ones no larger than itself, so n records
+// sit in O(log n) segments and each record is copied O(log n) times overall.
+struct FinishedSegment {
+    std::shared_ptr<const FinishedSegment> previous;
+    std::vector<std::shared_ptr<const RetiredProcess>> records;
+    size_t total = 0;  // records here and in every earlier segment
+};
+
+// Immutable system view published by the scheduler for monitoring commands.
+// Readers grab the current pointer and never touch live PCBs or scheduler locks.
+struct SystemSnapshot {
+    uint64_t version = 0;
+    std::string timestamp;
+    bool schedulerActive = false;
+    int numCpu = 0;
+    int coresUsed = 0;
+    std::vector<ProcessView> running;
+    size_t finishedCount = 0;
+    std::shared_ptr<const FinishedSegment> finished;  // newest segment (null: nothing finished yet)
+    std::vector<size_t> readyLevels;  // MLFQ queue depth per level (empty for other policies)
+    double fairnessIndex = 1.0;       // Jain index over the live processes' cpuShare
+    size_t pendingAdmissions = 0;     // built processes waiting for memory
+
+    bool hasMemory = false;                            // false before 'initialize'
+    MemoryStats memory;
+    std::vector<std::pair<int, size_t>> processMemory; // pid -> bytes
+};
+
+// Minimum time between two published snapshots
+constexpr int SNAPSHOT_INTERVAL_MS = 100;
+
+// Builds a fresh snapshot and publishes it as the current one
+std::shared_ptr<const SystemSnapshot> publish_snapshot();
+
+// Latest published snapshot; builds one on demand if the scheduler is not publishing
+std::shared_ptr<const SystemSnapshot> latest_snapshot();
+
+// The snapshot's finished processes in finishing order, skipping the first `from`
+std::vector<std::shared_ptr<const RetiredProcess>> finished_records(const SystemSnapshot& snap, size_t from = 0);
+
+#endif // CSOPESY_SNAPSHOT_H
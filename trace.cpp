@@ -0,0 +1,220 @@
+#include "trace.h"
+#include "registry.h"
+#include "utils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+std::atomic<bool> tracing_enabled{false};
+
+namespace {
+
+struct TraceRecord {
+    uint64_t timestamp; // ns since trace start
+    uint64_t arg;
+    int32_t pid;
+    TraceEventType type;
+};
+
+// Single-producer ring: only the bound thread writes, trace_dump reads while recording is paused
+struct TraceRing {
+    std::atomic<bool> busy{false};   // producer is inside trace_record
+    std::atomic<uint64_t> head{0};   // total events ever written
+    TraceRecord events[TRACE_RING_CAPACITY];
+};
+
+// Allocated by the owning thread on its first event, kept for the life of the program
+std::atomic<TraceRing*> lanes[MAX_TRACE_CORES + 1];
+std::atomic<int64_t> trace_epoch{0};
+std::mutex trace_control_mutex; // serializes start/stop/dump
+
+thread_local int trace_lane = -1;
+
+// Disables recording and waits for producers already inside trace_record to leave
+void quiesce() {
+    tracing_enabled.store(false);
+    for (auto& lane : lanes) {
+        TraceRing* ring = lane.load(std::memory_order_acquire);
+        if (!ring) continue;
+        while (ring->busy.load()) std::this_thread::yield();
+    }
+}
+
+const char* end_reason(TraceEventType type) {
+    switch (type) {
+        case TraceEventType::Preempt: return "preempt";
+        case TraceEventType::Sleep: return "sleep";
+        case TraceEventType::Terminate: return "terminate";
+        default: return "running";
+    }
+}
+
+// Chrome trace timestamps are microseconds
+std::string micros(uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu.%03llu", static_cast<unsigned long long>(ns / 1000),
+                  static_cast<unsigned long long>(ns % 1000));
+    return buf;
+}
+
+} // namespace
+
+void trace_bind_thread(int lane) {
+    // Cores are numbered below MAX_SCHEDULER_CORES, so none can share the watcher's single-producer lane
+    trace_lane = (lane >= 0 && lane <= TRACE_WATCHER_LANE) ? lane : -1;
+}
+
+uint64_t trace_now_ns() {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t since = now - trace_epoch.load(std::memory_order_relaxed);
+    return since > 0 ? static_cast<uint64_t>(since) : 0;
+}
+
+void trace_record(TraceEventType type, int pid, uint64_t arg) {
+    if (trace_lane < 0) return;
+    TraceRing* ring = lanes[trace_lane].load(std::memory_order_acquire);
+    if (!ring) {
+        ring = new TraceRing();
+        lanes[trace_lane].store(ring, std::memory_order_release);
+    }
+    // busy/enabled pairing lets quiesce() know no write is in flight once it returns
+    ring->busy.store(true);
+    if (!tracing_enabled.load()) {
+        ring->busy.store(false);
+        return;
+    }
+    uint64_t h = ring->head.load(std::memory_order_relaxed);
+    TraceRecord& e = ring->events[h % TRACE_RING_CAPACITY];
+    e.timestamp = trace_now_ns();
+    e.arg = arg;
+    e.pid = pid;
+    e.type = type;
+    ring->head.store(h + 1, std::memory_order_release);
+    ring->busy.store(false);
+}
+
+void trace_start() {
+    std::lock_guard<std::mutex> lock(trace_control_mutex);
+    quiesce();
+    for (auto& lane : lanes) {
+        TraceRing* ring = lane.load(std::memory_order_acquire);
+        if (ring) ring->head.store(0, std::memory_order_relaxed);
+    }
+    trace_epoch.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    tracing_enabled.store(true);
+}
+
+void trace_stop() {
+    std::lock_guard<std::mutex> lock(trace_control_mutex);
+    tracing_enabled.store(false);
+}
+
+bool trace_dump(const std::string& path, size_t& eventsWritten) {
+    eventsWritten = 0;
+
+    // Copy every lane while producers are paused, then resume and format at leisure
+    std::vector<std::vector<TraceRecord>> copies(MAX_TRACE_CORES + 1);
+    {
+        std::lock_guard<std::mutex> lock(trace_control_mutex);
+        bool wasEnabled = tracing_enabled.load();
+        quiesce();
+        for (int i = 0; i <= MAX_TRACE_CORES; ++i) {
+            TraceRing* ring = lanes[i].load(std::memory_order_acquire);
+            if (!ring) continue;
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t first = head > TRACE_RING_CAPACITY ? head - TRACE_RING_CAPACITY : 0;
+            copies[i].reserve(static_cast<size_t>(head - first));
+            for (uint64_t h = first; h < head; ++h) copies[i].push_back(ring->events[h % TRACE_RING_CAPACITY]);
+        }
+        if (wasEnabled) tracing_enabled.store(true);
+    }
+
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::unordered_map<int, std::string> names;
+    auto nameOf = [&names](int pid) -> const std::string& {
+        auto it = names.find(pid);
+        if (it != names.end()) return it->second;
+        std::string name = process_registry.nameOf(pid);
+        if (name.empty()) name = "process" + std::to_string(pid);
+        return names.emplace(pid, json_escape(name)).first->second;
+    };
+
+    bool firstEvent = true;
+    auto begin = [&]() -> std::ofstream& {
+        out << (firstEvent ? "\n" : ",\n");
+        firstEvent = false;
+        return out;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    begin() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CSOPESY scheduler\"}}";
+
+    for (int lane = 0; lane <= MAX_TRACE_CORES; ++lane) {
+        const auto& events = copies[lane];
+        if (events.empty()) continue;
+        std::string laneName = (lane == TRACE_WATCHER_LANE) ? "Sleep watcher" : "Core " + std::to_string(lane);
+        begin() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << lane
+                << ",\"args\":{\"name\":\"" << laneName << "\"}}";
+        begin() << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":" << lane
+                << ",\"args\":{\"sort_index\":" << lane << "}}";
+
+        // Pair each dispatch with the event that took the process off the core
+        bool open = false;
+        int openPid = -1;
+        uint64_t openStart = 0;
+        auto closeSlice = [&](uint64_t end, TraceEventType reason) {
+            begin() << "{\"name\":\"" << nameOf(openPid) << "\",\"cat\":\"run\",\"ph\":\"X\",\"pid\":0,\"tid\":" << lane
+                    << ",\"ts\":" << micros(openStart) << ",\"dur\":" << micros(end - openStart)
+                    << ",\"args\":{\"pid\":" << openPid << ",\"end\":\"" << end_reason(reason) << "\"}}";
+            ++eventsWritten;
+            open = false;
+        };
+
+        for (const auto& e : events) {
+            switch (e.type) {
+                case TraceEventType::Dispatch:
+                    if (open) closeSlice(e.timestamp, TraceEventType::Dispatch);
+                    open = true;
+                    openPid = e.pid;
+                    openStart = e.timestamp;
+                    break;
+                case TraceEventType::Preempt:
+                case TraceEventType::Sleep:
+                case TraceEventType::Terminate:
+                    if (open && openPid == e.pid) closeSlice(e.timestamp, e.type);
+                    break;
+                case TraceEventType::Wake:
+                    begin() << "{\"name\":\"wake " << nameOf(e.pid) << "\",\"cat\":\"sleep\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":"
+                            << lane << ",\"ts\":" << micros(e.timestamp) << ",\"args\":{\"pid\":" << e.pid << "}}";
+                    ++eventsWritten;
+                    break;
+                case TraceEventType::PageFault:
+                    begin() << "{\"name\":\"page fault\",\"cat\":\"memory\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":" << lane
+                            << ",\"ts\":" << micros(e.timestamp) << ",\"args\":{\"pid\":" << e.pid
+                            << ",\"address\":" << e.arg << "}}";
+                    ++eventsWritten;
+                    break;
+                case TraceEventType::LockWait: {
+                    uint64_t start = e.timestamp > e.arg ? e.timestamp - e.arg : 0;
+                    begin() << "{\"name\":\"ready-queue lock wait\",\"cat\":\"lock\",\"ph\":\"X\",\"pid\":0,\"tid\":" << lane
+                            << ",\"ts\":" << micros(start) << ",\"dur\":" << micros(e.timestamp - start) << "}";
+                    ++eventsWritten;
+                    break;
+                }
+            }
+        }
+        if (open) closeSlice(events.back().timestamp, TraceEventType::Dispatch); // still on the core
+    }
+
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,48 @@
+#ifndef CSOPESY_TRACE_H
+#define CSOPESY_TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ready_queue.h"
+
+// Scheduler event tracer. Always compiled in; when tracing is off every
+// trace point costs one relaxed atomic load. Each core thread (and the sleep
+// watcher) owns a single-producer ring buffer, so recording takes no locks.
+enum class TraceEventType : uint8_t {
+    Dispatch,  // process picked up by a core
+    Preempt,   // quantum expired, process back in the ready queue
+    Sleep,     // process blocked on SLEEP (arg = ticks)
+    Wake,      // sleep watcher made the process ready again
+    PageFault, // demand-paging fault (arg = virtual address)
+    Terminate, // process finished
+    LockWait   // ready-queue lock acquisition took long (arg = wait in ns)
+};
+
+constexpr int MAX_TRACE_CORES = MAX_SCHEDULER_CORES; // lanes 0..MAX_TRACE_CORES-1 belong to cores
+constexpr int TRACE_WATCHER_LANE = MAX_TRACE_CORES;   // sleep watcher thread
+constexpr size_t TRACE_RING_CAPACITY = 1 << 15;      // events kept per lane (oldest overwritten)
+constexpr uint64_t TRACE_LOCK_WAIT_NS = 10000;       // lock waits shorter than this are not recorded
+
+extern std::atomic<bool> tracing_enabled;
+
+// Binds the calling thread to a lane; threads without a lane record nothing
+void trace_bind_thread(int lane);
+// Nanoseconds since the current trace started
+uint64_t trace_now_ns();
+// Slow path of trace_event; only called while tracing is enabled
+void trace_record(TraceEventType type, int pid, uint64_t arg);
+
+inline void trace_event(TraceEventType type, int pid, uint64_t arg = 0) {
+    if (tracing_enabled.load(std::memory_order_relaxed)) trace_record(type, pid, arg);
+}
+
+// Clears all lanes and starts recording
+void trace_start();
+void trace_stop();
+// Writes recorded events as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Recording is paused while the lanes are copied. Returns false if the file cannot be written.
+bool trace_dump(const std::string& path, size_t& eventsWritten);
+
+#endif // CSOPESY_TRACE_H
@@ -0,0 +1,120 @@
+#include "tuner.h"
+#include "globals.h"
+#include "metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+
+std::atomic<int> current_quantum{5};
+
+static std::atomic<uint64_t> sleep_burst_sum{0};
+static std::atomic<uint64_t> sleep_burst_count{0};
+
+// Counter values at the previous decision (only the tuning thread touches these)
+static uint64_t last_tick = 0;
+static uint64_t last_instructions = 0;
+static uint64_t last_switches = 0;
+static uint64_t last_burst_sum = 0;
+static uint64_t last_burst_count = 0;
+
+static std::mutex tuning_log_mutex;
+static std::deque<std::string> tuning_log;
+
+static int clamp_quantum(int q) {
+    int low = std::max(1, quantum_min);
+    int high = std::max(low, quantum_max);
+    return std::max(low, std::min(q, high));
+}
+
+void quantum_tuner_reset() {
+    current_quantum = quantum_auto ? clamp_quantum(quantum_cycles) : std::max(1, quantum_cycles);
+    last_tick = static_cast<uint64_t>(cpuCycles.load());
+    last_instructions = instructions_executed.load();
+    last_switches = context_switches.load();
+    last_burst_sum = sleep_burst_sum.load();
+    last_burst_count = sleep_burst_count.load();
+    std::lock_guard<std::mutex> lock(tuning_log_mutex);
+    tuning_log.clear();
+}
+
+void quantum_tuner_record_sleep_burst(int executed) {
+    if (!quantum_auto || executed <= 0) return;
+    sleep_burst_sum.fetch_add(static_cast<uint64_t>(executed), std::memory_order_relaxed);
+    sleep_burst_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void quantum_tuner_tick(uint64_t now, int cores) {
+    if (!quantum_auto || now < last_tick + QUANTUM_TUNE_INTERVAL) return;
+
+    uint64_t instructions = instructions_executed.load();
+    uint64_t switches = context_switches.load();
+    uint64_t burstSum = sleep_burst_sum.load();
+    uint64_t burstCount = sleep_burst_count.load();
+    uint64_t ran = instructions - last_instructions;
+    uint64_t switched = switches - last_switches;
+    uint64_t bursts = burstCount - last_burst_count;
+    double avgBurst = bursts > 0 ? static_cast<double>(burstSum - last_burst_sum) / static_cast<double>(bursts) : 0.0;
+    last_tick = now;
+    last_instructions = instructions;
+    last_switches = switches;
+    last_burst_sum = burstSum;
+    last_burst_count = burstCount;
+    if (ran == 0) return; // idle interval, nothing to learn from
+
+    size_t ready = 0;
+    {
+        std::unique_lock<std::mutex> lock(process_table_mutex);
+        ready = ready_queue.size();
+    }
+    if (ready == 0) return; // nobody waits for a core, so the quantum does not matter
+
+    int q = current_quantum.load();
+    double switchPct = 100.0 * static_cast<double>(switched) / static_cast<double>(ran);
+    // Roughly how long a newly queued process waits for its turn
+    double readyWait = static_cast<double>(ready) / std::max(1, cores) * q;
+
+    int next = q;
+    const char* reason = nullptr;
+    if (quantum_target_response > 0 && readyWait > quantum_target_response) {
+        next = q - std::max(1, q / 4);
+        reason = "ready wait above target";
+    } else if (switchPct > quantum_target_switch) {
+        // Only grow while the longer quantum keeps the ready wait comfortably on
+        // target (20% margin, so the two rules do not undo each other every interval)
+        next = q + std::max(1, q / 4);
+        if (quantum_target_response > 0 && readyWait / q * next > 0.8 * quantum_target_response) next = q;
+        reason = "switch overhead above target";
+    } else if (switchPct < quantum_target_switch / 2.0) {
+        next = q - std::max(1, q / 8);
+        reason = "switch overhead well below target";
+    }
+    // Let a typical burst before SLEEP finish inside one quantum
+    if (bursts > 0 && next < static_cast<int>(avgBurst) + 1) {
+        next = static_cast<int>(avgBurst) + 1;
+        reason = "fits sleep bursts";
+    }
+    next = clamp_quantum(next);
+    if (next == q || !reason) return;
+
+    current_quantum = next;
+    char line[192];
+    std::snprintf(line, sizeof(line), "tick %llu: quantum %d -> %d (%s; switches %.1f%%, ready %zu, sleep burst %.1f)",
+                  static_cast<unsigned long long>(now), q, next, reason, switchPct, ready, avgBurst);
+    std::lock_guard<std::mutex> lock(tuning_log_mutex);
+    tuning_log.push_back(line);
+    if (tuning_log.size() > QUANTUM_LOG_SIZE) tuning_log.pop_front();
+}
+
+std::string format_quantum_tuning() {
+    std::string out = "Quantum: " + std::to_string(current_quantum.load()) + " cycles";
+    if (!quantum_auto) return out + "\n";
+    out += " (auto, " + std::to_string(clamp_quantum(1)) + "-" + std::to_string(clamp_quantum(quantum_max)) +
+           ", target switches " + std::to_string(static_cast<int>(quantum_target_switch)) + "%";
+    if (quantum_target_response > 0) out += ", ready wait " + std::to_string(quantum_target_response) + " ticks";
+    out += ")\n";
+    std::lock_guard<std::mutex> lock(tuning_log_mutex);
+    for (const auto& line : tuning_log) out += "  " + line + "\n";
+    return out;
+}
@@ -0,0 +1,27 @@
+#ifndef CSOPESY_TUNER_H
+#define CSOPESY_TUNER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Adaptive time slice for 'quantum-cycles auto'. Every QUANTUM_TUNE_INTERVAL
+// ticks the tuner compares the context-switch rate, the bursts processes run
+// before SLEEP and the ready-queue length against the configured targets, and
+// moves the quantum within [quantum-min, quantum-max].
+constexpr uint64_t QUANTUM_TUNE_INTERVAL = 100;   // ticks between decisions
+constexpr size_t QUANTUM_LOG_SIZE = 8;            // decisions kept for vmstat
+
+// Quantum the schedulers use now; equals quantum-cycles unless auto tuning is on
+extern std::atomic<int> current_quantum;
+
+// Starts from quantum-cycles and clears the decision log (scheduler start)
+void quantum_tuner_reset();
+// A process ran `executed` instructions and then blocked on SLEEP
+void quantum_tuner_record_sleep_burst(int executed);
+// Makes a decision if an interval has passed since the last one (no-op unless auto)
+void quantum_tuner_tick(uint64_t now, int cores);
+// Current quantum and, in auto mode, the latest decisions
+std::string format_quantum_tuning();
+
+#endif // CSOPESY_TUNER_H
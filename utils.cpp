@@ -1,7 +1,9 @@
 // utils.cpp
 #include "utils.h"
+#include "keyboard.h"
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
 #include <sstream>
 #include <csignal>
 #include <iomanip>
@@ -73,13 +75,14 @@ std::string log_format(int core_id, const std::string &instruction) {
     return oss.str();
 }
 
+// Atomic: the interpreter and every generator thread draw from these
 int generate_pid() {
-    static int pid = 1;
+    static std::atomic<int> pid{1};
     return pid++;
 }
 
 std::string generate_process_name() {
-    static int process_name = 1;
+    static std::atomic<int> process_name{1};
     std::ostringstream oss;
     oss << "p" << std::setw(2) << std::setfill('0') << process_name++;
     return oss.str();
@@ -121,6 +124,24 @@ bool parse_hex_address(const std::string& hexStr, size_t& outAddress) {
     }
 }
 
+// Quotes, backslashes and control characters escaped for a JSON string
+std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
 // Parse integer string to int
 bool parse_integer(const std::string& str, int& outValue) {
     if (str.empty()) return false;
@@ -136,6 +157,7 @@ bool parse_integer(const std::string& str, int& outValue) {
 // Simple SIGINT handler to cleanup nicely
 void handle_sigint(int) {
     is_running = false;
+    wake_keyboard_thread();
 #ifndef _WIN32
     disable_raw_mode();
 #endif
@@ -189,115 +211,3 @@ void enable_windows_ansi() {
     SetConsoleMode(hOut, mode);
 }
 #endif
-
-// Parse user-defined instructions from command string
-#include "process.h"
-#include <sstream>
-#include <algorithm>
-#include <cctype>
-
-static std::string trim(const std::string& str) {
-    size_t start = 0;
-    while (start < str.size() && std::isspace(str[start])) start++;
-    size_t end = str.size();
-    while (end > start && std::isspace(str[end - 1])) end--;
-    return str.substr(start, end - start);
-}
-
-static std::vector<std::string> splitByDelimiter(const std::string& str, char delim) {
-    std::vector<std::string> tokens;
-    std::string current;
-    bool inQuotes = false;
-    
-    for (char c : str) {
-        if (c == '"') {
-            inQuotes = !inQuotes;
-            current += c;
-        } else if (c == delim && !inQuotes) {
-            if (!current.empty()) {
-                tokens.push_back(trim(current));
-                current.clear();
-            }
-        } else {
-            current += c;
-        }
-    }
-    
-    if (!current.empty()) {
-        tokens.push_back(trim(current));
-    }
-    
-    return tokens;
-}
-
-std::vector<Instruction> parseUserInstructions(const std::string& instructionString) {
-    std::vector<Instruction> instructions;
-    
-    // Split by semicolon
-    std::vector<std::string> instrLines = splitByDelimiter(instructionString, ';');
-    
-    for (const auto& line : instrLines) {
-        if (line.empty()) continue;
-        
-        std::istringstream iss(line);
-        std::string cmd;
-        iss >> cmd;
-        
-        // Convert to uppercase for comparison
-        std::string upperCmd = cmd;
-        for (char& c : upperCmd) c = std::toupper(c);
-        
-        Instruction instr;
-        
-        if (upperCmd == "PRINT") {
-            instr.type = PRINT;
-            // Get rest of line as print argument
-            std::string rest;
-            std::getline(iss, rest);
-            instr.arg1 = trim(rest);
-            instructions.push_back(instr);
-        }
-        else if (upperCmd == "DECLARE") {
-            instr.type = DECLARE;
-            iss >> instr.arg1 >> instr.val1;
-            instructions.push_back(instr);
-        }
-        else if (upperCmd == "ADD") {
-            instr.type = ADD;
-            iss >> instr.arg1 >> instr.arg2 >> instr.arg3;
-            instructions.push_back(instr);
-        }
-        else if (upperCmd == "SUBTRACT") {
-            instr.type = SUBTRACT;
-            iss >> instr.arg1 >> instr.arg2 >> instr.arg3;
-            instructions.push_back(instr);
-        }
-        else if (upperCmd == "WRITE") {
-            instr.type = WRITE_MEM;
-            std::string addrStr;
-            iss >> addrStr >> instr.arg2;  // WRITE <address> <variable>
-            size_t addr;
-            if (parse_hex_address(addrStr, addr)) {
-                instr.arg1 = addrStr;  // Store hex address string
-            }
-            instructions.push_back(instr);
-        }
-        else if (upperCmd == "READ") {
-            instr.type = READ_MEM;
-            std::string addrStr;
-            iss >> instr.arg1 >> addrStr;  // READ <variable> <address>
-            size_t addr;
-            if (parse_hex_address(addrStr, addr)) {
-                instr.arg2 = addrStr;  // Store hex address string
-            }
-            instructions.push_back(instr);
-        }
-        else if (upperCmd == "SLEEP") {
-            instr.type = SLEEP;
-            iss >> instr.val1;
-            instructions.push_back(instr);
-        }
-    }
-    
-    return instructions;
-}
@@ -20,10 +20,7 @@ bool is_power_of_two(size_t n);
 bool is_valid_memory_size(size_t size);
 bool parse_hex_address(const std::string& hexStr, size_t& outAddress);
 bool parse_integer(const std::string& str, int& outValue);
-
-// Instruction parsing
-struct Instruction;
-std::vector<Instruction> parseUserInstructions(const std::string& instructionString);
+std::string json_escape(const std::string& s);
 
 #ifndef _WIN32
 void enable_raw_mode();
@@ -0,0 +1,343 @@
+#include "workload.h"
+#include "globals.h"
+#include "rng.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+static std::shared_ptr<const WorkloadProfile> current_profile; // only via std::atomic_load/atomic_store
+static std::string load_error; // last load_workload_profile failure (interpreter thread only)
+
+static bool mix_type(const std::string& name, InstructionType& type) {
+    static const std::pair<const char*, InstructionType> names[] = {
+        {"print", PRINT}, {"declare", DECLARE}, {"add", ADD}, {"subtract", SUBTRACT},
+        {"sleep", SLEEP}, {"for", FOR_LOOP}, {"read", READ_MEM}, {"write", WRITE_MEM}};
+    for (const auto& entry : names) {
+        if (name == entry.first) {
+            type = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads "<low> <high>" into an ordered pair
+template <typename T>
+static bool read_range(std::istringstream& iss, T& low, T& high) {
+    if (!(iss >> low >> high)) return false;
+    if (high < low) std::swap(low, high);
+    return true;
+}
+
+static bool parse_line(std::istringstream& iss, const std::string& key, WorkloadProfile& p, std::string& error) {
+    if (key == "mix") {
+        std::string name;
+        double weight;
+        while (iss >> name) {
+            InstructionType type;
+            if (!mix_type(name, type)) {
+                error = "unknown instruction '" + name + "'";
+                return false;
+            }
+            if (!(iss >> weight) || weight < 0) {
+                error = "mix needs a non-negative weight after '" + name + "'";
+                return false;
+            }
+            p.mix[type] = weight;
+        }
+        return true;
+    }
+    if (key == "instructions") {
+        if (!read_range(iss, p.minInstructions, p.maxInstructions) || p.minInstructions < 1) {
+            error = "instructions needs <min> <max>, at least 1";
+            return false;
+        }
+        return true;
+    }
+    if (key == "addresses") {
+        std::string kind;
+        iss >> kind;
+        if (kind == "uniform") {
+            p.addresses = AddressPattern::Uniform;
+        } else if (kind == "sequential") {
+            p.addresses = AddressPattern::Sequential;
+            size_t stride;
+            if (iss >> stride) p.stride = std::max<size_t>(2, stride);
+        } else if (kind == "zipf") {
+            p.addresses = AddressPattern::Zipf;
+            if (!(iss >> p.zipfSkew) || p.zipfSkew <= 0) {
+                error = "zipf needs a positive skew";
+                return false;
+            }
+        } else if (kind == "hotset") {
+            p.addresses = AddressPattern::HotSet;
+            if (!(iss >> p.hotFraction >> p.hotProbability) || p.hotFraction <= 0 || p.hotFraction > 1 ||
+                p.hotProbability < 0 || p.hotProbability > 1) {
+                error = "hotset needs <fraction> in (0, 1] and <probability> in [0, 1]";
+                return false;
+            }
+        } else {
+            error = "addresses must be uniform, sequential, zipf or hotset";
+            return false;
+        }
+        return true;
+    }
+    if (key == "sleep-ticks") {
+        if (!read_range(iss, p.sleepMin, p.sleepMax) || p.sleepMin < 1 || p.sleepMax > 255) {
+            error = "sleep-ticks needs <min> <max> within 1-255";
+            return false;
+        }
+        return true;
+    }
+    if (key == "loop-depth") {
+        if (!(iss >> p.loopDepth) || p.loopDepth < 0 || p.loopDepth > 3) {
+            error = "loop-depth must be 0-3";
+            return false;
+        }
+        return true;
+    }
+    if (key == "loop-iterations" || key == "loop-body") {
+        int& low = key == "loop-body" ? p.loopBodyMin : p.loopIterationsMin;
+        int& high = key == "loop-body" ? p.loopBodyMax : p.loopIterationsMax;
+        if (!read_range(iss, low, high) || low < 1) {
+            error = key + " needs <min> <max>, at least 1";
+            return false;
+        }
+        return true;
+    }
+    if (key == "mem-size") {
+        if (!read_range(iss, p.memMin, p.memMax)) {
+            error = "mem-size needs <min> <max> [uniform|pow2]";
+            return false;
+        }
+        p.memMin = std::max(p.memMin, MIN_MEMORY_SIZE);
+        p.memMax = std::min(std::max(p.memMax, p.memMin), MAX_MEMORY_SIZE);
+        std::string kind;
+        if (iss >> kind) p.memPow2 = kind == "pow2";
+        return true;
+    }
+    if (key == "variables") {
+        if (!(iss >> p.variables) || p.variables < 1 || p.variables > static_cast<int>(MAX_VARIABLES)) {
+            error = "variables must be 1-" + std::to_string(MAX_VARIABLES);
+            return false;
+        }
+        return true;
+    }
+    error = "unknown setting '" + key + "'";
+    return false;
+}
+
+bool parse_workload_profile(const std::string& path, WorkloadProfile& profile, std::string& error) {
+    std::ifstream ifs(path);
+    if (!ifs) {
+        error = "cannot open " + path;
+        return false;
+    }
+    profile = WorkloadProfile();
+    profile.name = path.substr(path.find_last_of("/\\") + 1);
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(ifs, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream iss(line);
+        std::string key;
+        if (!(iss >> key)) continue;
+        if (!parse_line(iss, key, profile, error)) {
+            error = path + ":" + std::to_string(lineNumber) + ": " + error;
+            return false;
+        }
+    }
+
+    double straight = 0.0; // weight of everything but FOR, which needs a body to expand to
+    for (size_t type = 0; type < profile.mix.size(); ++type) {
+        if (type != FOR_LOOP) straight += profile.mix[type];
+    }
+    if (straight == 0.0) {
+        if (profile.mix[FOR_LOOP] > 0) {
+            error = path + ": mix needs some instruction other than for";
+            return false;
+        }
+        // No mix given: the built-in generator's WRITE/READ/PRINT/ADD, in equal parts
+        profile.mix[PRINT] = profile.mix[ADD] = profile.mix[READ_MEM] = profile.mix[WRITE_MEM] = 1.0;
+    }
+    if (profile.loopDepth == 0) profile.mix[FOR_LOOP] = 0.0;
+    return true;
+}
+
+std::shared_ptr<const WorkloadProfile> active_workload() {
+    return std::atomic_load(&current_profile);
+}
+
+bool load_workload_profile(const std::string& path, std::string& error) {
+    std::shared_ptr<const WorkloadProfile> next;
+    bool ok = true;
+    if (!path.empty()) {
+        auto profile = std::make_shared<WorkloadProfile>();
+        ok = parse_workload_profile(path, *profile, error);
+        if (ok) next = std::move(profile);
+    }
+    load_error = ok ? "" : error;
+    std::atomic_store(&current_profile, next);
+    return ok;
+}
+
+std::string describe_workload() {
+    if (!load_error.empty()) return "workload profile not loaded: " + load_error;
+    auto profile = active_workload();
+    return profile ? "workload: " + profile->name : "";
+}
+
+size_t workload_process_memory(const WorkloadProfile& profile) {
+    if (profile.memMax == 0) return 0;
+    std::mt19937& gen = thread_rng();
+    if (!profile.memPow2) return std::uniform_int_distribution<size_t>(profile.memMin, profile.memMax)(gen);
+    int low = 0;
+    while ((size_t{1} << low) < profile.memMin) low++;
+    if ((size_t{1} << low) > profile.memMax) return profile.memMax; // no power of two in range
+    int high = low;
+    while ((size_t{2} << high) <= profile.memMax) high++;
+    return size_t{1} << std::uniform_int_distribution<int>(low, high)(gen);
+}
+
+// Cumulative 1/k^skew weights for `words` ranks. Cached per thread: a run uses
+// one or a few memory sizes, so the table is built once, not per process.
+static const std::vector<double>& zipf_cdf(size_t words, double skew) {
+    thread_local size_t cachedWords = 0;
+    thread_local double cachedSkew = 0.0;
+    thread_local std::vector<double> cdf;
+    if (words != cachedWords || skew != cachedSkew) {
+        cdf.resize(words);
+        double sum = 0.0;
+        for (size_t k = 0; k < words; ++k) {
+            sum += 1.0 / std::pow(static_cast<double>(k + 1), skew);
+            cdf[k] = sum;
+        }
+        cachedWords = words;
+        cachedSkew = skew;
+    }
+    return cdf;
+}
+
+// Per-process generation state
+struct WorkloadGenerator {
+    const WorkloadProfile& profile;
+    std::mt19937& gen;
+    std::discrete_distribution<int> mix;
+    std::discrete_distribution<int> mixNoLoop; // once loops are nested loop-depth deep
+    std::vector<std::string> variables;
+    std::vector<std::string> printArgs;
+    // Data segment: 2-byte words after the symbol table, so accesses stay in bounds
+    size_t base = 0;
+    size_t words = 1;
+    size_t cursor = 0;
+    size_t hotStart = 0;
+    size_t hotWords = 1;
+
+    WorkloadGenerator(const WorkloadProfile& p, size_t memorySize)
+        : profile(p), gen(thread_rng()), mix(p.mix.begin(), p.mix.end()) {
+        std::vector<double> noLoop = p.mix;
+        noLoop[FOR_LOOP] = 0.0;
+        mixNoLoop = std::discrete_distribution<int>(noLoop.begin(), noLoop.end());
+        for (int v = 0; v < p.variables; ++v) {
+            variables.push_back("v" + std::to_string(v));
+            printArgs.push_back("Value from: " + variables.back());
+        }
+        base = memorySize >= SYMBOL_TABLE_SIZE + 2 ? SYMBOL_TABLE_SIZE : 0;
+        words = std::max<size_t>(1, (memorySize - base) / 2);
+        hotWords = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(words) * p.hotFraction));
+        hotStart = std::uniform_int_distribution<size_t>(0, words - hotWords)(gen);
+    }
+
+    size_t variableIndex() {
+        return std::uniform_int_distribution<size_t>(0, variables.size() - 1)(gen);
+    }
+    const std::string& variable() { return variables[variableIndex()]; }
+
+    size_t word() {
+        switch (profile.addresses) {
+            case AddressPattern::Sequential: {
+                size_t w = cursor;
+                cursor = (cursor + profile.stride / 2) % words;
+                return w;
+            }
+            case AddressPattern::Zipf: {
+                const auto& cdf = zipf_cdf(words, profile.zipfSkew);
+                double u = std::uniform_real_distribution<double>(0.0, cdf.back())(gen);
+                return std::min<size_t>(words - 1, std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+            }
+            case AddressPattern::HotSet: {
+                if (hotWords == words || std::bernoulli_distribution(profile.hotProbability)(gen)) {
+                    return hotStart + std::uniform_int_distribution<size_t>(0, hotWords - 1)(gen);
+                }
+                size_t w = std::uniform_int_distribution<size_t>(0, words - hotWords - 1)(gen);
+                return w < hotStart ? w : w + hotWords;
+            }
+            case AddressPattern::Uniform:
+                break;
+        }
+        return std::uniform_int_distribution<size_t>(0, words - 1)(gen);
+    }
+
+    std::string address() {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "0x%zx", base + 2 * word());
+        return buf;
+    }
+
+    void body(int depth, int count, std::vector<Instruction>& out) {
+        for (int i = 0; i < count; ++i) {
+            Instruction instruction;
+            instruction.type = static_cast<InstructionType>(depth < profile.loopDepth ? mix(gen) : mixNoLoop(gen));
+            switch (instruction.type) {
+                case PRINT:
+                    instruction.arg2 = printArgs[variableIndex()];
+                    break;
+                case DECLARE:
+                    instruction.arg1 = variable();
+                    instruction.val1 = static_cast<uint16_t>(gen());
+                    break;
+                case ADD:
+                case SUBTRACT:
+                    instruction.arg1 = variable();
+                    instruction.arg2 = variable();
+                    instruction.arg3 = variable();
+                    break;
+                case SLEEP:
+                    instruction.val1 = static_cast<uint16_t>(
+                        std::uniform_int_distribution<int>(profile.sleepMin, profile.sleepMax)(gen));
+                    break;
+                case FOR_LOOP:
+                    instruction.val1 = static_cast<uint16_t>(
+                        std::uniform_int_distribution<int>(profile.loopIterationsMin, profile.loopIterationsMax)(gen));
+                    body(depth + 1, std::uniform_int_distribution<int>(profile.loopBodyMin, profile.loopBodyMax)(gen),
+                         instruction.instrSet);
+                    break;
+                case READ_MEM:
+                    instruction.arg1 = variable();
+                    instruction.arg2 = address();
+                    break;
+                case WRITE_MEM:
+                    instruction.arg1 = address();
+                    instruction.arg2 = variable();
+                    break;
+            }
+            out.push_back(std::move(instruction));
+        }
+    }
+};
+
+void generate_workload_instructions(const WorkloadProfile& profile, size_t memorySize, std::vector<Instruction>& out) {
+    WorkloadGenerator generator(profile, memorySize);
+    int low = profile.maxInstructions > 0 ? profile.minInstructions : min_ins;
+    int high = profile.maxInstructions > 0 ? profile.maxInstructions : std::max(min_ins, max_ins);
+    int count = std::uniform_int_distribution<int>(low, high)(generator.gen);
+    out.reserve(out.size() + static_cast<size_t>(count));
+    generator.body(0, count, out);
+}
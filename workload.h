@@ -0,0 +1,70 @@
+#ifndef CSOPESY_WORKLOAD_H
+#define CSOPESY_WORKLOAD_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "process.h"
+
+// Where READ/WRITE instructions of generated processes point
+enum class AddressPattern {
+    Uniform,     // any word of the data segment
+    Sequential,  // a cursor walking the data segment by `stride` bytes
+    Zipf,        // word k is hit with probability ~ 1/k^skew
+    HotSet       // `hotFraction` of the segment takes `hotProbability` of the accesses
+};
+
+// Workload profile file ('workload-profile <path>' in config.txt), one
+// setting per line, '#' starts a comment:
+//   mix print 2 add 4 sleep 1 read 2 write 2   relative weights (also declare, subtract, for)
+//   instructions 10000 20000                   top-level count per process (default min-ins/max-ins)
+//   addresses zipf 1.1                         uniform | sequential [stride] | zipf <skew> | hotset <fraction> <probability>
+//   sleep-ticks 5 40
+//   loop-depth 2                               FOR nesting, 0-3
+//   loop-iterations 1 4
+//   loop-body 1 5
+//   mem-size 256 4096 pow2                     uniform | pow2 (default max-mem-per-proc)
+//   variables 4                                1-32
+struct WorkloadProfile {
+    std::string name;                // file name, shown by 'initialize'
+    // Weights indexed by InstructionType
+    std::vector<double> mix = std::vector<double>(WRITE_MEM + 1, 0.0);
+    int minInstructions = 0;         // 0 = use min-ins/max-ins
+    int maxInstructions = 0;
+    AddressPattern addresses = AddressPattern::Uniform;
+    size_t stride = 2;
+    double zipfSkew = 1.0;
+    double hotFraction = 0.1;
+    double hotProbability = 0.9;
+    int sleepMin = 1;
+    int sleepMax = 10;
+    int loopDepth = 1;
+    int loopIterationsMin = 1;
+    int loopIterationsMax = 3;
+    int loopBodyMin = 1;
+    int loopBodyMax = 5;
+    size_t memMin = 0;               // 0 = generated_process_memory()'s default
+    size_t memMax = 0;
+    bool memPow2 = false;
+    int variables = 1;
+};
+
+// Parses `path`; false with `error` set (including the line number) on a bad file
+bool parse_workload_profile(const std::string& path, WorkloadProfile& profile, std::string& error);
+
+// Profile used by the process generator; null means the built-in WRITE/READ/PRINT/ADD cycle
+std::shared_ptr<const WorkloadProfile> active_workload();
+// Loads `path` as the active profile ("" clears it); on failure the old one is cleared too
+bool load_workload_profile(const std::string& path, std::string& error);
+// "workload: <name>", the last load error, or "" when no profile is configured
+std::string describe_workload();
+
+// Memory size for a new process under `profile`, or 0 if it does not set one
+size_t workload_process_memory(const WorkloadProfile& profile);
+// Fills `out` with a new process body. Uses thread_rng(); O(1) per instruction
+// apart from a log-time Zipf lookup.
+void generate_workload_instructions(const WorkloadProfile& profile, size_t memorySize, std::vector<Instruction>& out);
+
+#endif // CSOPESY_WORKLOAD_H